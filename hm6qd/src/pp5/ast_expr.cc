@@ -0,0 +1,703 @@
+/* File: ast_expr.cc
+ * -----------------
+ * Implementation of expression node classes.
+ */
+#include "ast_expr.h"
+#include "ast_type.h"
+#include "ast_decl.h"
+#include <string.h>
+#include "codegen.h"
+
+
+void Expr::codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue){
+    Location *value = codegen(cgen);
+    if (jumpIfTrue)
+        cgen->GenIfCmp(BinaryOp::NotEq, value, cgen->GenLoadConstant(0), label);
+    else
+        cgen->GenIfZ(value, label);
+}
+
+IntConstant::IntConstant(yyltype loc, int val) : Expr(loc) {
+    value = val;
+    type=Type::intType;
+}
+
+Location* IntConstant::codegen(CodeGenerator * cgen){
+    return cgen->GenLoadConstant(value);
+}
+
+DoubleConstant::DoubleConstant(yyltype loc, double val) : Expr(loc) {
+    value = val;
+    type=Type::doubleType;
+}
+
+BoolConstant::BoolConstant(yyltype loc, bool val) : Expr(loc) {
+    value = val;
+    type=Type::boolType;
+}
+
+Location* BoolConstant::codegen(CodeGenerator * cgen){
+    return cgen->GenLoadConstant(value ? 1 : 0);
+}
+
+StringConstant::StringConstant(yyltype loc, const char *val) : Expr(loc) {
+    Assert(val != NULL);
+    value = strdup(val);
+    type=Type::stringType;
+}
+
+Location* StringConstant::codegen(CodeGenerator * cgen){
+    return cgen->GenLoadConstant(value);
+}
+
+NullConstant::NullConstant(yyltype loc) : Expr(loc) {
+    type=Type::nullType;
+}
+
+Location* NullConstant::codegen(CodeGenerator * cgen){
+    return cgen->GenLoadConstant(0);
+}
+
+Operator::Operator(yyltype loc, const char *tok) : Node(loc) {
+    Assert(tok != NULL);
+    strncpy(tokenString, tok, sizeof(tokenString));
+}
+
+bool Operator::Equals(const char* tok){
+    return strncmp(tokenString, tok, 2)==0;
+}
+
+CompoundExpr::CompoundExpr(Expr *l, Operator *o, Expr *r) 
+  : Expr(Join(l->GetLocation(), r->GetLocation())) {
+    Assert(l != NULL && o != NULL && r != NULL);
+    (op=o)->SetParent(this);
+    (left=l)->SetParent(this); 
+    (right=r)->SetParent(this);
+}
+
+CompoundExpr::CompoundExpr(Operator *o, Expr *r) 
+  : Expr(Join(o->GetLocation(), r->GetLocation())) {
+    Assert(o != NULL && r != NULL);
+    left = NULL; 
+    (op=o)->SetParent(this);
+    (right=r)->SetParent(this);
+}
+   
+Location* CompoundExpr::codegen(CodeGenerator* cgen){
+    //Assume binary here
+    Location * l = left->codegen(cgen);
+    Location * r = right->codegen(cgen);
+    return cgen->GenBinaryOp(op->GetName(), l, r);   
+
+}
+
+Location* ArithmeticExpr::codegen(CodeGenerator* cgen){
+    if (left)
+        return CompoundExpr::codegen(cgen);
+    Location * l = cgen->GenLoadConstant(0);
+    Location * r = right->codegen(cgen);
+    return cgen->GenBinaryOp(op->GetName(), l, r);   
+}
+
+void CompoundExpr::codegenCompareBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue){
+    Location * l = left->codegen(cgen);
+    Location * r = right->codegen(cgen);
+    BinaryOp::OpCode rel = BinaryOp::OpCodeForName(op->GetName());
+    cgen->GenIfCmp(jumpIfTrue ? rel : BinaryOp::Negate(rel), l, r, label);
+}
+
+// Every relation has its own Tac operator (and MIPS set instruction)
+Location* RelationalExpr::codegen(CodeGenerator* cgen){
+    return CompoundExpr::codegen(cgen);
+}
+
+void RelationalExpr::codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue){
+    codegenCompareBranch(cgen, label, jumpIfTrue);
+}
+
+Location* EqualityExpr::codegen(CodeGenerator* cgen){
+    if (left->InferType() != Type::stringType)
+        return CompoundExpr::codegen(cgen);
+    Location * l = left->codegen(cgen);
+    Location * r = right->codegen(cgen);
+    Location * equal = cgen->GenBuiltInCall(StringEqual, l, r);
+    if (strcmp(op->GetName(), "==") == 0)
+        return equal;
+    return cgen->GenBinaryOp("==", equal, cgen->GenLoadConstant(0));
+}
+
+void EqualityExpr::codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue){
+    if (left->InferType() == Type::stringType)  // compared by value, not address
+        Expr::codegenBranch(cgen, label, jumpIfTrue);
+    else
+        codegenCompareBranch(cgen, label, jumpIfTrue);
+}
+
+// && and || only evaluate the right operand when the left one does not
+// already decide the result, so even as a value they are built from
+// branches: result is 1 on the fall-through path and 0 on the jump.
+Location* LogicalExpr::codegen(CodeGenerator* cgen){
+    if (left) {
+        Location * result = cgen->GenTempVar();
+        const char * isFalse = cgen->NewLabel();
+        const char * end = cgen->NewLabel();
+        codegenBranch(cgen, isFalse, false);
+        cgen->GenAssign(result, cgen->GenLoadConstant(1));
+        cgen->GenGoto(end);
+        cgen->GenLabel(isFalse);
+        cgen->GenAssign(result, cgen->GenLoadConstant(0));
+        cgen->GenLabel(end);
+        return result;
+    }
+    Assert(strncmp(op->GetName(), "!", 4)==0);
+    Location * l = cgen->GenLoadConstant(0);
+    Location * r = right->codegen(cgen);
+    return cgen->GenBinaryOp("==", r, l);   
+}
+
+// For a && b, a false left operand jumps straight past the right one
+// (or to label, when looking for false); || is the mirror image, and !
+// just flips the sense of the test.
+void LogicalExpr::codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue){
+    if (!left) {
+        right->codegenBranch(cgen, label, !jumpIfTrue);
+        return;
+    }
+    bool isAnd = op->Equals("&&");
+    if (isAnd != jumpIfTrue) {
+        // a && b jumping if false, a || b jumping if true
+        left->codegenBranch(cgen, label, jumpIfTrue);
+        right->codegenBranch(cgen, label, jumpIfTrue);
+        return;
+    }
+    const char * skip = cgen->NewLabel();
+    left->codegenBranch(cgen, skip, !jumpIfTrue);
+    right->codegenBranch(cgen, label, jumpIfTrue);
+    cgen->GenLabel(skip);
+}
+
+// An array element or field is stored to where it lives in memory;
+// anything else is a variable, assigned to directly.
+Location* AssignExpr::codegen(CodeGenerator * cgen){
+    ArrayAccess* element = dynamic_cast<ArrayAccess*>(left);
+    FieldAccess* field = dynamic_cast<FieldAccess*>(left);
+
+    if (element){
+        Location * addr = element->codegenAddress(cgen);
+        Location * scr = right->codegen(cgen);
+        cgen->GenStore(addr, scr);
+        return scr;
+    }
+    if (field && field->IsField()){
+        Location * obj = field->codegenObject(cgen);
+        Location * scr = right->codegen(cgen);
+        cgen->GenStore(obj, scr, field->FieldOffset());
+        return scr;
+    }
+    Location * dst = left->codegen(cgen);
+    Location * scr = right->codegen(cgen);
+    cgen->GenAssign(dst, scr);
+    return dst;
+}
+void AssignExpr::Emit(CodeGenerator * cgen){
+    codegen(cgen);
+}
+
+ArrayAccess::ArrayAccess(yyltype loc, Expr *b, Expr *s) : LValue(loc) {
+    (base=b)->SetParent(this); 
+    (subscript=s)->SetParent(this);
+}
+
+Location* ArrayAccess::codegen(CodeGenerator* cgen){
+    return cgen->GenLoad(codegenAddress(cgen));
+}
+
+Location* ArrayAccess::codegenAddress(CodeGenerator* cgen){
+    Location* baseLoc = base->codegen(cgen);
+    Location* subLoc = subscript->codegen(cgen);
+    return cgen->GenArrayAccess(baseLoc, subLoc);
+}
+
+     
+FieldAccess::FieldAccess(Expr *b, Identifier *f) 
+  : LValue(b? Join(b->GetLocation(), f->GetLocation()) : *f->GetLocation()) {
+    Assert(f != NULL); // b can be be NULL (just means no explicit base)
+    base = b; 
+    if (base) base->SetParent(this); 
+    (field=f)->SetParent(this);
+    baseDecl=NULL;
+    classDecl=NULL;
+    fieldDecl=NULL;
+}
+
+/*
+1. Object.field
+2. (this.)field
+3. 
+
+*/
+Type* FieldAccess::InferType(){
+    if (type) return type;
+    Type* baseType = base? base->InferType() : NULL;
+    fieldDecl = field->GetDeclForId(baseType);
+    if (fieldDecl)
+        type=dynamic_cast<VarDecl*>(fieldDecl)->GetDeclaredType();
+
+    if (!base){
+        // if no base and is field, this.field
+        if (fieldDecl && fieldDecl->IsFieldDecl()) { 
+            base = new This(*field->GetLocation()); //??
+            base->SetParent(this);
+            base->InferType();
+
+        }else if (fieldDecl && !fieldDecl->IsFieldDecl()){
+            //not inside class, global var
+        }
+    }
+
+    if (base && !base->InferType()){
+
+       //printf("FieldAccess::InferType(): base && !base->InferType()\n");
+    }
+
+    if (base && base->InferType()->IsNamedType()){
+        FieldAccess* _base = dynamic_cast<FieldAccess*>(base);
+        baseDecl = _base? _base->fieldDecl : NULL; //what about classdecl??
+        classDecl= dynamic_cast<NamedType*> (base->InferType()) -> GetDeclForType();
+    }
+
+/*
+    if (base){
+        l=kShallow;
+        
+        FieldAccess* _base= dynamic_cast<FieldAccess*>(base);
+        if (!_base) {
+            //printf("FieldAccess::InferType(): Cannot convert Expr to FieldAccess\n");
+        }
+
+        baseDecl= _base->fieldDecl;
+
+        if (baseDecl->IsVarDecl()){ 
+            //get the classDecl for the var
+            NamedType* t =dynamic_cast<NamedType*> (dynamic_cast<VarDecl*>(baseDecl)->GetDeclaredType());
+            classDecl =t->GetDeclForType();
+
+            fieldDecl=classDecl-> FindDecl(field, kShallow);
+
+            // Infer Type
+            if (!fieldDecl) {
+                // ReportError::FieldNotFoundInBase(field, base->InferType());
+                //printf("FieldAccess::InferType(): FieldNotFoundInBase(%s)\n",field->GetName());
+                type=Type::errorType;
+                // return;
+            }
+            type=dynamic_cast<VarDecl*> (fieldDecl)->GetDeclaredType();
+        }
+
+    } else {
+
+        if (!fieldDecl)
+            fieldDecl= FindDecl(field, kDeep);
+        if (fieldDecl->IsVarDecl()){
+
+            type=dynamic_cast<VarDecl*>(fieldDecl)->GetDeclaredType();
+            NamedType* t =dynamic_cast<NamedType*> (type);
+            if (t){
+                classDecl = t->GetDeclForType();
+            }
+        }
+    }
+*/
+    return type;
+
+}
+
+Location* FieldAccess::codegen(CodeGenerator* cgen){
+    if (IsField())
+        return cgen->GenLoad(codegenObject(cgen), FieldOffset());
+    return fieldDecl->tacloc;
+}
+
+bool FieldAccess::IsField(){
+    InferType();
+    return fieldDecl && fieldDecl->IsFieldDecl();
+}
+
+// An implicit this has been made explicit by InferType
+Location* FieldAccess::codegenObject(CodeGenerator* cgen){
+    Assert(IsField() && base);
+    return base->codegen(cgen);
+}
+
+// Fields come after the vtable pointer
+int FieldAccess::FieldOffset(){
+    return fieldDecl->GetOffset() + CodeGenerator::VarSize;
+}
+
+Call::Call(yyltype loc, Expr *b, Identifier *f, List<Expr*> *a) : Expr(loc)  {
+    Assert(f != NULL && a != NULL); // b can be be NULL (just means no explicit base)
+    base = b;
+    if (base) base->SetParent(this);
+    (field=f)->SetParent(this);
+    (actuals=a)->SetParentAll(this);
+}
+ 
+Type* Call::InferType(){
+    if (type) return type;
+
+    //Check Array.length()
+    if (base && base->InferType() && base->InferType()->IsArrayType() && strcmp(field->GetName(), "length") == 0) {
+        // if (actuals->NumElements() != 0) 
+            // ReportError::NumArgsMismatch(field, 0, actuals->NumElements());
+        type= Type::intType;
+    }
+
+    Type* baseType = base? base->InferType() : NULL;
+    funcDecl = field->GetDeclForId(baseType);
+
+    // if funcDecl found and can be converted to FnDecl
+    if (funcDecl && funcDecl->IsFnDecl())
+        type=dynamic_cast<FnDecl*>(funcDecl)->GetReturnType();
+
+    if (!base){
+        // if no base and is method, this.field
+        if (funcDecl && funcDecl->IsMethodDecl()) { 
+            base = new This(*field->GetLocation()); //??
+            base->SetParent(this);
+            base->InferType();
+
+        }else if (funcDecl && !funcDecl->IsMethodDecl()){
+            //not inside class, global func
+        }
+    }
+
+    if (base && !base->InferType()){
+       //printf("FieldAccess::InferType(): base && !base->InferType()\n");
+    }
+
+    if (base && base->InferType()->IsNamedType()){
+        FieldAccess* _base = dynamic_cast<FieldAccess*>(base);
+        baseDecl = _base? _base->fieldDecl : NULL; //what about classdecl??
+        classDecl= dynamic_cast<NamedType*> (base->InferType()) -> GetDeclForType();
+    }
+
+
+/*    if (base){
+        base->InferType();
+        FieldAccess* _base= dynamic_cast<FieldAccess*>(base);
+        if (!_base) {
+            //printf("Cannot convert Expr to FieldAccess\n");
+        }
+
+        //Check Array.length()
+        if (base->InferType() && base->InferType()->IsArrayType() && strcmp(field->GetName(), "length") == 0) {
+            // if (actuals->NumElements() != 0) 
+                // ReportError::NumArgsMismatch(field, 0, actuals->NumElements());
+            return Type::intType;
+        }
+
+        if (_base->classDecl){
+            funcDecl=(_base->classDecl-> FindDecl(field, kShallow));
+            FnDecl* _funcDecl = dynamic_cast<FnDecl*> (funcDecl);
+            if (!_funcDecl) {
+                //printf("Call::InferType(): cannot find funcDecl\n");
+                type=Type::errorType;
+            }
+            type=_funcDecl->GetReturnType();
+        }else{
+            //printf("Call::InferType(): no classDecl in base!\n");
+        }
+
+    }else{
+        funcDecl = (FindDecl(field));
+        FnDecl* _funcDecl = dynamic_cast<FnDecl*> (funcDecl);
+        type=_funcDecl? _funcDecl->GetReturnType() : NULL;
+    }
+*/
+
+    return type;
+} 
+
+Location* Call::codegen(CodeGenerator* cgen){
+
+    InferType();
+    Location * result = NULL;
+
+    //Array.length()
+    if (base && base->InferType() && base->InferType()->IsArrayType() && strcmp(field->GetName(), "length") == 0) { 
+        Location* baseLoc = base->codegen(cgen);
+        result = cgen->GenArrayLen(baseLoc);
+        return result;
+    }
+
+    FnDecl* _funcDecl = dynamic_cast<FnDecl*>(funcDecl);
+    Assert(_funcDecl->NumArgs()==actuals->NumElements());
+
+    List<Location*> *params = new List<Location*>;
+    for (int i=0; i<actuals->NumElements(); i++){
+        params->Append(actuals->Nth(i)->codegen(cgen));
+    }
+
+    ClassDecl *baseClass = NULL;
+    NamedType *baseType = base ? dynamic_cast<NamedType*>(base->InferType()) : NULL;
+    if (baseType) baseClass = dynamic_cast<ClassDecl*>(baseType->GetDeclForType());
+    const char *target = baseClass ? baseClass->GetUniqueMethodLabel(_funcDecl->GetOffset()) : NULL;
+
+    if (target){
+        // monomorphic: no subclass overrides the method, so skip the vtable
+        result = cgen->GenStaticDispatch(base->codegen(cgen), target, params, _funcDecl->GetReturnType()!=Type::voidType);
+    }else if (base){
+        result = cgen->GenDynamicDispatch(base->codegen(cgen), _funcDecl->GetOffset(), params, _funcDecl->GetReturnType()!=Type::voidType);
+    }else{
+        for (int i=actuals->NumElements()-1; i>=0; i--){
+            cgen->GenPushParam(params->Nth(i));
+        }
+        result=cgen->GenLCall(_funcDecl->GetFuncLabel(), _funcDecl->GetReturnType()!=Type::voidType);
+        cgen->GenPopParams(cgen->VarSize * actuals->NumElements());
+    }
+    return result;
+
+}
+
+NewExpr::NewExpr(yyltype loc, NamedType *c) : Expr(loc) { 
+  Assert(c != NULL);
+  (cType=c)->SetParent(this);
+  type=cType;
+}
+
+Location* NewExpr::codegen(CodeGenerator *cgen) { 
+    Location *result;
+    ClassDecl *cd = dynamic_cast<ClassDecl*>(cType->GetDeclForType());
+    result = cgen->GenNew(cd->GetName(), cd->fieldCount); 
+    return result;
+}
+
+
+NewArrayExpr::NewArrayExpr(yyltype loc, Expr *sz, Type *et) : Expr(loc) {
+    Assert(sz != NULL && et != NULL);
+    (size=sz)->SetParent(this); 
+    (elemType=et)->SetParent(this);
+}
+
+Type * NewArrayExpr::InferType() {
+    if (type) return type;
+    size->InferType();
+    // if (!sizet->IsCompatibleWith(Type::intType))
+    //     ReportError::NewArraySizeNotInteger(size);
+    // elemType->Check();
+    type = new ArrayType(*GetLocation(), elemType);
+    return type;
+}
+
+Location* NewArrayExpr::codegen(CodeGenerator* cgen){
+    Location *result = cgen->GenNewArray(size->codegen(cgen), elemType->IsPointerType());
+    return result;
+}
+
+Type* ReadIntegerExpr::InferType(){
+    return Type::intType;
+}
+
+Location* ReadIntegerExpr::codegen(CodeGenerator* cgen){
+    return cgen->GenBuiltInCall(ReadInteger);
+}
+
+Type* ReadLineExpr::InferType(){
+    return Type::stringType;
+}
+
+Location* ReadLineExpr::codegen(CodeGenerator* cgen){
+    return cgen->GenBuiltInCall(ReadLine);
+}
+
+PostfixExpr::PostfixExpr(LValue *lv, Operator *o) : Expr(Join(lv->GetLocation(), o->GetLocation())) {
+    Assert(lv != NULL && o != NULL);
+    (lvalue=lv)->SetParent(this);
+    (op=o)->SetParent(this);
+}
+
+Type* PostfixExpr::InferType(){
+    if (type) return type;
+    type = lvalue->InferType();
+    return type;
+}
+
+Location* PostfixExpr::codegen(CodeGenerator* cgen){
+    return Increment(cgen, true);
+}
+
+// As a statement (or a for step) the old value is not needed
+void PostfixExpr::Emit(CodeGenerator* cgen){
+    Increment(cgen, false);
+}
+
+// A variable is added to where it lives; an array element or field is
+// loaded, added to and stored back.
+Location* PostfixExpr::Increment(CodeGenerator* cgen, bool wantOld){
+    int delta = op->Equals("++") ? 1 : -1;
+    ArrayAccess* element = dynamic_cast<ArrayAccess*>(lvalue);
+    FieldAccess* field = dynamic_cast<FieldAccess*>(lvalue);
+    Location* obj = NULL;
+    int offset = 0;
+
+    if (element) {
+        obj = element->codegenAddress(cgen);
+    } else if (field && field->IsField()) {
+        obj = field->codegenObject(cgen);
+        offset = field->FieldOffset();
+    }
+    if (obj) {
+        Location* old = cgen->GenLoad(obj, offset);
+        Location* val = cgen->GenBinaryOp("+", old, cgen->GenLoadConstant(delta));
+        cgen->GenStore(obj, val, offset);
+        return old;
+    }
+
+    Location* var = lvalue->codegen(cgen);
+    Location* old = NULL;
+    if (wantOld) {
+        old = cgen->GenTempVar();
+        cgen->GenAssign(old, var);
+    }
+    cgen->GenIncrement(var, delta);
+    return old;
+}
+  
+Type* ArithmeticExpr::InferType(){
+    if (type) return type;
+
+    if (left){
+        //two operands
+        if (right->InferType()->IsEquivalentTo(left->InferType())){
+            if (right->InferType()==Type::intType || right->InferType()==Type::doubleType){
+                type=right->InferType();
+                return type;
+            }
+        }    
+        //else left exists and not equivalent
+        type=Type::errorType;
+        // ReportError::IncompatibleOperands(op, left->InferType(), right->InferType());
+
+    }else{
+        //unary operation
+        if (right->InferType()==Type::intType || right->InferType()==Type::doubleType){
+            type=right->InferType();
+            return type;
+        }
+        type=Type::errorType;
+        // ReportError::IncompatibleOperand(op, right->InferType());
+    }
+
+    return type;
+}
+
+Type* RelationalExpr::InferType(){
+    if (type) return type;
+
+    if (left){
+        //two operands
+        if (right->InferType()->IsEquivalentTo(left->InferType())){
+            if (right->InferType()==Type::intType || right->InferType()==Type::doubleType){
+                type=Type::boolType;
+                return type;
+            }
+        }    
+        //else left exists and not equivalent
+        type=Type::errorType;
+        // ReportError::IncompatibleOperands(op, left->InferType(), right->InferType());
+
+    }else{
+        type=Type::errorType;
+        // ReportError::IncompatibleOperands( op, Type::voidType,right->InferType());
+    }
+
+    return type;
+}
+
+Type* EqualityExpr::InferType(){
+    if (type) return type;
+
+    if (left){
+        //two operands
+        if (right->InferType()->IsEquivalentTo(left->InferType()) || left->InferType()->IsEquivalentTo(right->InferType())){
+                //Objects & null
+                type=Type::boolType;
+                return type;
+        }    
+        //else left exists and not equivalent
+        type=Type::errorType;
+        // ReportError::IncompatibleOperands(op, left->InferType(), right->InferType());
+
+    }else{
+        type=Type::errorType;
+        // ReportError::IncompatibleOperands( op, Type::voidType,right->InferType());
+    }
+
+    return type;
+}
+
+Type* LogicalExpr::InferType(){
+    if (type) return type;
+
+    if (left){
+        //two operands
+        if (right->InferType()==Type::boolType || right->InferType()==Type::boolType){
+            type=Type::boolType;
+            return type;
+        }
+        //else left exists and not equivalent
+        type=Type::errorType;
+        // ReportError::IncompatibleOperands(op, left->InferType(), right->InferType());
+
+    }else{
+        //unary operation
+        if (right->InferType()==Type::boolType){
+            type=Type::boolType;
+            return type;
+        }
+        type=Type::errorType;
+        // ReportError::IncompatibleOperand(op, right->InferType());
+    }
+
+    return type;
+}
+
+Type* AssignExpr::InferType(){
+    if (type) return type;
+    if (left->InferType()->IsEquivalentTo(right->InferType())){
+        // ReportError::IncompatibleOperands(op, left->InferType(), right->InferType());
+        type = left->InferType();
+    }
+
+    return type;
+}
+
+Type* This::InferType(){
+    if (type) return type;
+
+    Node* current=this;
+    while((current=current->GetParent())){
+        if (current->IsClassDecl()){
+            decl=dynamic_cast<ClassDecl*> (current);
+            break;
+        }
+    }
+ 
+    type=decl->GetDeclaredType();
+    return type;
+}
+
+Location* This::codegen(CodeGenerator* cgen){
+    return CodeGenerator::ThisPtr;
+}
+
+// The type of an element, not of the array
+Type* ArrayAccess::InferType(){
+    if (type) return type;
+    subscript->InferType();
+    ArrayType* arrayType = dynamic_cast<ArrayType*>(base->InferType());
+    type = arrayType ? arrayType->GetElemType() : Type::errorType;
+    return type;
+}
+
+       
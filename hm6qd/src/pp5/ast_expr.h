@@ -0,0 +1,312 @@
+/* File: ast_expr.h
+ * ----------------
+ * The Expr class and its subclasses are used to represent
+ * expressions in the parse tree.  For each expression in the
+ * language (add, call, New, etc.) there is a corresponding
+ * node class for that construct. 
+ *
+ * pp5: You will need to extend the Expr classes to implement 
+ * code generation for expressions.
+ */
+
+
+#ifndef _H_ast_expr
+#define _H_ast_expr
+
+#include "ast.h"
+#include "ast_stmt.h"
+#include "list.h"
+#include "codegen.h"
+// #include "scope.h"
+
+class NamedType; // for new
+class Type; // for NewArray
+
+
+class Expr : public Stmt 
+{
+  public:
+    Type * type;
+    Expr(yyltype loc) : Stmt(loc) {}
+    Expr() : Stmt() {}
+    virtual Type* InferType(){return type;}
+    virtual bool isArrayType(){return false;}
+
+    virtual Location* codegen(CodeGenerator * cgen){
+      // printf("/**************** To be implemented!! ********************/\n");
+      return NULL;
+    };
+    virtual void Emit(CodeGenerator *cgen){codegen(cgen);}
+    virtual bool IsArrayAccess(){return false; }
+
+    // Generates code that jumps to label if the value of the expression
+    // is jumpIfTrue and falls through otherwise. Used for the tests of
+    // if/while/for, where the value itself is never needed.
+    virtual void codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue);
+
+};
+
+/* This node type is used for those places where an expression is optional.
+ * We could use a NULL pointer, but then it adds a lot of checking for
+ * NULL. By using a valid, but no-op, node, we save that trouble */
+class EmptyExpr : public Expr
+{
+  public:
+};
+
+class IntConstant : public Expr 
+{
+  protected:
+    int value;
+  
+  public:
+    IntConstant(yyltype loc, int val);
+    int GetValue() { return value; }
+    Location* codegen(CodeGenerator * cgen);
+};
+
+class DoubleConstant : public Expr 
+{
+  protected:
+    double value;
+    
+  public:
+    DoubleConstant(yyltype loc, double val);
+};
+
+class BoolConstant : public Expr 
+{
+  protected:
+    bool value;
+    
+  public:
+    BoolConstant(yyltype loc, bool val);
+    Location* codegen(CodeGenerator * cgen);
+};
+
+class StringConstant : public Expr 
+{ 
+  protected:
+    char *value;
+    
+  public:
+    StringConstant(yyltype loc, const char *val);
+    Location* codegen(CodeGenerator * cgen);
+};
+
+class NullConstant: public Expr 
+{
+  public: 
+    NullConstant(yyltype loc) ;
+    Location* codegen(CodeGenerator * cgen);
+};
+
+class Operator : public Node 
+{
+  protected:
+    char tokenString[4];
+    
+  public:
+    Operator(yyltype loc, const char *tok);
+    friend std::ostream& operator<<(std::ostream& out, Operator *o) { return out << o->tokenString; }
+    char* GetName(){return tokenString;}
+    bool Equals(const char * tok);
+ };
+ 
+class CompoundExpr : public Expr
+{
+  protected:
+    Operator *op;
+    Expr *left, *right; // left will be NULL if unary
+    
+  public:
+    CompoundExpr(Expr *lhs, Operator *op, Expr *rhs); // for binary
+    CompoundExpr(Operator *op, Expr *rhs);             // for unary
+    virtual Location* codegen(CodeGenerator* cgen);
+
+  protected:
+    // Branch on the relation itself (IfCmp), no boolean in between
+    void codegenCompareBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue);
+};
+
+class ArithmeticExpr : public CompoundExpr 
+{
+  public:
+    ArithmeticExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
+    ArithmeticExpr(Operator *op, Expr *rhs) : CompoundExpr(op,rhs) {}
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+};
+
+class RelationalExpr : public CompoundExpr 
+{
+  public:
+    RelationalExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+    void codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue);
+};
+
+class EqualityExpr : public CompoundExpr 
+{
+  public:
+    EqualityExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
+    const char *GetPrintNameForNode() { return "EqualityExpr"; }
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+    void codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue);
+};
+
+class LogicalExpr : public CompoundExpr 
+{
+  public:
+    LogicalExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
+    LogicalExpr(Operator *op, Expr *rhs) : CompoundExpr(op,rhs) {}
+    const char *GetPrintNameForNode() { return "LogicalExpr"; }
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+    void codegenBranch(CodeGenerator *cgen, const char *label, bool jumpIfTrue);
+};
+
+class AssignExpr : public CompoundExpr 
+{
+  public:
+    AssignExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
+    const char *GetPrintNameForNode() { return "AssignExpr"; }
+    Location * codegen(CodeGenerator * cgen);
+    void Emit(CodeGenerator * cgen);
+    Type* InferType();
+    bool IsAssignExpr(){return true; }
+};
+
+class LValue : public Expr 
+{
+  public:
+    LValue(yyltype loc) : Expr(loc) {}
+};
+
+class This : public Expr 
+{
+  public:
+    ClassDecl* decl;
+    This(yyltype loc) : Expr(loc) {}
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+};
+
+class ArrayAccess : public LValue 
+{
+  protected:
+    Expr *base, *subscript;
+    
+  public:
+    ArrayAccess(yyltype loc, Expr *base, Expr *subscript);
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+    // The address of the element, once its subscript is checked
+    Location* codegenAddress(CodeGenerator* cgen);
+    bool IsArrayAccess(){return true; }
+};
+
+/* Note that field access is used both for qualified names
+ * base.field and just field without qualification. We don't
+ * know for sure whether there is an implicit "this." in
+ * front until later on, so we use one node type for either
+ * and sort it out later. */
+class FieldAccess : public LValue 
+{
+  protected:
+    Expr *base;	// will be NULL if no explicit base
+    Identifier *field;
+    
+  public:
+    Decl * baseDecl;
+    Decl * classDecl;
+    Decl * fieldDecl;
+    FieldAccess(Expr *base, Identifier *field); //ok to pass NULL base
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+    // For a field of an object rather than a variable: the object, and
+    // the offset of the field in it
+    bool IsField();
+    Location* codegenObject(CodeGenerator* cgen);
+    int FieldOffset();
+};
+
+/* Like field access, call is used both for qualified base.field()
+ * and unqualified field().  We won't figure out until later
+ * whether we need implicit "this." so we use one node type for either
+ * and sort it out later. */
+class Call : public Expr 
+{
+  protected:
+    Expr *base;	// will be NULL if no explicit base
+    Identifier *field;
+    List<Expr*> *actuals;
+    
+  public:
+    Decl* funcDecl;
+    Decl* baseDecl;
+    Decl* classDecl;
+    Call(yyltype loc, Expr *base, Identifier *field, List<Expr*> *args);
+    Location* codegen(CodeGenerator* cgen);
+    Type* InferType();
+};
+
+class NewExpr : public Expr
+{
+  protected:
+    NamedType *cType;
+    
+  public:
+    NewExpr(yyltype loc, NamedType *clsType);
+    Location* codegen(CodeGenerator * cgen);
+};
+
+class NewArrayExpr : public Expr
+{
+  protected:
+    Expr *size;
+    Type *elemType;
+    
+  public:
+    NewArrayExpr(yyltype loc, Expr *sizeExpr, Type *elemType);
+    Type * InferType();
+    Location* codegen(CodeGenerator* cgen);
+};
+
+class ReadIntegerExpr : public Expr
+{
+  public:
+    ReadIntegerExpr(yyltype loc) : Expr(loc) {}
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+};
+
+class ReadLineExpr : public Expr
+{
+  public:
+    ReadLineExpr(yyltype loc) : Expr (loc) {}
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+};
+
+class PostfixExpr : public Expr
+{
+protected:
+    LValue *lvalue;
+    Operator *op;
+public:
+    PostfixExpr(LValue *lv, Operator *op);
+    // void Check(); //???
+    Type* InferType();
+    Location* codegen(CodeGenerator* cgen);
+    void Emit(CodeGenerator* cgen);
+
+    // Adds 1 or -1 to the lvalue in place, returning the old value if
+    // wanted (or else NULL)
+    Location* Increment(CodeGenerator* cgen, bool wantOld);
+};
+
+   
+#endif
@@ -0,0 +1,417 @@
+/* File: bce.cc
+ * ------------
+ * Implementation of the BoundsCheckElimination class.
+ */
+
+#include "bce.h"
+#include "cfg.h"
+#include "codegen.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <map>
+
+
+bool BoundsCheckElimination::Fact::operator<(const Fact &f) const
+{
+  if (kind != f.kind) return kind < f.kind;
+  if (var != f.var) return var < f.var;
+  if (array != f.array) return array < f.array;
+  return k < f.k;
+}
+
+BoundsCheckElimination::BoundsCheckElimination(FlowGraph *g, CodeGenerator *cg)
+  : cfg(g), hoisted(0)
+{
+  HoistChecks(cg);
+  Solve();
+}
+
+bool BoundsCheckElimination::IsTracked(Location *var)
+{
+  return var && var->GetSegment() == fpRelative;
+}
+
+bool BoundsCheckElimination::IsCheck(Instruction *instr)
+{
+  IfCmp *cmp = dynamic_cast<IfCmp*>(instr);
+  return cmp && cmp->opcode() == BinaryOp::UnsignedGreaterEq;
+}
+
+void BoundsCheckElimination::Add(Facts &gen, Kind kind, Location *var,
+                                 Location *array, int k)
+{
+  if (!IsTracked(var) || (array && !IsTracked(array))) return;
+  Fact f = {kind, var, array, k};
+  gen.insert(f);
+}
+
+/* Method: Find
+ * ------------
+ * Is there a fact of the given kind about var (and array, if given)?
+ * If so its constant is stored in k. Facts are ordered by constant, so
+ * for BelowConst that is the tightest bound.
+ */
+bool BoundsCheckElimination::Find(const Facts &s, Kind kind, Location *var,
+                                  int *k, Location *array)
+{
+  for (Facts::const_iterator it = s.begin(); it != s.end(); ++it)
+    if (it->kind == kind && it->var == var && (!array || it->array == array)) {
+      if (k) *k = it->k;
+      return true;
+    }
+  return false;
+}
+
+/* Method: GenAdd
+ * --------------
+ * Facts about dst = v + c for a constant c. dst stays non-negative only
+ * if the add cannot overflow, which a bound on v rules out: anything
+ * below an array length is at most INT_MAX - 1. Taking a constant off a
+ * length leaves something below it, and adding 4 to the address of a
+ * freshly allocated array header yields the array itself.
+ */
+void BoundsCheckElimination::GenAdd(const Facts &s, Location *dst, Location *v,
+                                    int c, Facts &gen)
+{
+  int k;
+  bool nonneg = Find(s, NonNeg, v);
+  if (c >= 0 && nonneg &&
+      (c == 0 || (c == 1 && Find(s, BelowLen, v)) ||
+       (Find(s, BelowConst, v, &k) && (long long)k - 1 + c <= INT_MAX)))
+    Add(gen, NonNeg, dst, NULL);
+  if (Find(s, BelowConst, v, &k) && (c >= 0 || nonneg) &&
+      (long long)k + c <= INT_MAX && (long long)k + c >= INT_MIN)
+    Add(gen, BelowConst, dst, NULL, k + c);
+  for (Facts::const_iterator it = s.begin(); it != s.end(); ++it) {
+    if (c <= 0 && nonneg && it->kind == BelowLen && it->var == v)
+      Add(gen, BelowLen, dst, it->array);
+    if (c < 0 && it->kind == LenOf && it->var == v)
+      Add(gen, BelowLen, dst, it->array);   // e.g. a.length() - 1
+  }
+  if (c == CodeGenerator::VarSize && Find(s, HeaderLen, v, &k))
+    Add(gen, LenAtLeast, dst, NULL, k);
+}
+
+/* Method: Transfer
+ * ----------------
+ * Updates s across instr: the facts it generates are worked out from
+ * the state before it, then every fact mentioning its destination is
+ * dropped and the new ones added.
+ */
+void BoundsCheckElimination::Transfer(Instruction *instr, Facts &s)
+{
+  Facts gen;
+  Location *dst = instr->GetDst();
+  Location *srcs[Instruction::MaxSources];
+  int c;
+  instr->GetSources(srcs);
+  LoadConstant *lc = dynamic_cast<LoadConstant*>(instr);
+  Load *load = dynamic_cast<Load*>(instr);
+  Store *store = dynamic_cast<Store*>(instr);
+  BinaryOp *op = dynamic_cast<BinaryOp*>(instr);
+
+  if (lc) {
+    Add(gen, Const, dst, NULL, lc->value());
+    if (lc->value() >= 0) Add(gen, NonNeg, dst, NULL);
+  } else if (dynamic_cast<Assign*>(instr)) {
+    for (Facts::iterator it = s.begin(); it != s.end(); ++it) {
+      if (it->var == srcs[0]) Add(gen, it->kind, dst, it->array, it->k);
+      if (it->array == srcs[0]) Add(gen, it->kind, it->var, dst, it->k);
+    }
+  } else if (load && load->GetOffset() == -CodeGenerator::VarSize) {
+    Add(gen, LenOf, dst, srcs[0]);       // the length word of array src
+    Add(gen, NonNeg, dst, NULL);
+  } else if (store && store->GetOffset() == 0) {
+    if (Find(s, Const, srcs[1], &c) && c >= 0)
+      Add(gen, HeaderLen, srcs[0], NULL, c);
+  } else if (op && op->opcode() == BinaryOp::Add) {
+    if (Find(s, Const, srcs[1], &c)) GenAdd(s, dst, srcs[0], c, gen);
+    if (Find(s, Const, srcs[0], &c)) GenAdd(s, dst, srcs[1], c, gen);
+  } else if (op && op->opcode() == BinaryOp::Sub) {
+    if (Find(s, Const, srcs[1], &c) && c != INT_MIN)
+      GenAdd(s, dst, srcs[0], -c, gen);
+  }
+
+  if (IsTracked(dst)) {
+    for (Facts::iterator it = s.begin(); it != s.end(); ) {
+      if (it->var == dst || it->array == dst)
+        s.erase(it++);
+      else
+        ++it;
+    }
+  }
+  s.insert(gen.begin(), gen.end());
+}
+
+/* Method: AssumeLess
+ * ------------------
+ * Adds to s what x < y (or x <= y if not strict) tells us.
+ */
+void BoundsCheckElimination::AssumeLess(Facts &s, Location *x, Location *y, bool strict)
+{
+  Facts gen;
+  int k;
+  if (Find(s, Const, y, &k) && (strict || k < INT_MAX))
+    Add(gen, BelowConst, x, NULL, strict ? k : k + 1);
+  if (strict)
+    for (Facts::iterator it = s.begin(); it != s.end(); ++it)
+      if (it->kind == LenOf && it->var == y)
+        Add(gen, BelowLen, x, it->array);
+  if (Find(s, NonNeg, x) || (Find(s, Const, x, &k) && k >= (strict ? -1 : 0)))
+    Add(gen, NonNeg, y, NULL);
+  s.insert(gen.begin(), gen.end());
+}
+
+/* Method: Refine
+ * --------------
+ * Adds to s the facts that hold on the edge out of branch, which is the
+ * jump if taken and the fall-through otherwise. Falling through a check
+ * x >=u y where y >= 0 means 0 <= x < y.
+ */
+void BoundsCheckElimination::Refine(Facts &s, CondBranch *branch, bool taken)
+{
+  IfCmp *cmp = dynamic_cast<IfCmp*>(branch);
+  if (!cmp) return;
+  Location *srcs[Instruction::MaxSources];
+  cmp->GetSources(srcs);
+  Location *x = srcs[0], *y = srcs[1];
+  BinaryOp::OpCode rel = cmp->opcode();
+  int k;
+
+  if (rel == BinaryOp::UnsignedGreaterEq) {
+    if (!taken && (Find(s, NonNeg, y) || (Find(s, Const, y, &k) && k >= 0))) {
+      Add(s, NonNeg, x, NULL);
+      AssumeLess(s, x, y, true);
+    }
+    return;
+  }
+  if (rel == BinaryOp::Eq || rel == BinaryOp::NotEq) return;
+  if (!taken) rel = BinaryOp::Negate(rel);
+  switch (rel) {
+    case BinaryOp::Less:      AssumeLess(s, x, y, true);  break;
+    case BinaryOp::LessEq:    AssumeLess(s, x, y, false); break;
+    case BinaryOp::Greater:   AssumeLess(s, y, x, true);  break;
+    case BinaryOp::GreaterEq: AssumeLess(s, y, x, false); break;
+    default:                  break;
+  }
+}
+
+/* Method: InBounds
+ * ----------------
+ * Is 0 <= subscript < length certain in s? The upper bound comes either
+ * from a test against the length of the same array, or from a constant
+ * bound no bigger than the size the array was allocated with.
+ */
+bool BoundsCheckElimination::InBounds(const Facts &s, Location *subscript, Location *length)
+{
+  int k;
+  long long below = (long long)INT_MAX + 1;
+  if (Find(s, BelowConst, subscript, &k)) below = k;
+  if (Find(s, Const, subscript, &k)) {
+    below = std::min(below, (long long)k + 1);
+    if (k < 0) return false;
+  } else if (!Find(s, NonNeg, subscript))
+    return false;
+
+  for (Facts::const_iterator it = s.begin(); it != s.end(); ++it) {
+    if (it->kind != LenOf || it->var != length) continue;
+    Location *array = it->array;
+    if (Find(s, BelowLen, subscript, NULL, array)) return true;
+    for (Facts::const_iterator a = s.begin(); a != s.end(); ++a)
+      if (a->kind == LenAtLeast && a->var == array && below <= a->k)
+        return true;
+  }
+  return false;
+}
+
+/* Method: Propagate
+ * -----------------
+ * Merges s into the entry state of to, keeping the facts common to
+ * both, and queues to if that changed anything. The first edge to reach
+ * a block sets its state outright.
+ */
+void BoundsCheckElimination::Propagate(BasicBlock *to, const Facts &s)
+{
+  if (!visited[to->id]) {
+    visited[to->id] = true;
+    in[to->id] = s;
+    worklist.push_back(to);
+    return;
+  }
+  Facts merged;
+  std::set_intersection(in[to->id].begin(), in[to->id].end(), s.begin(), s.end(),
+                        std::inserter(merged, merged.begin()));
+  if (merged.size() != in[to->id].size()) {
+    in[to->id] = merged;
+    worklist.push_back(to);
+  }
+}
+
+void BoundsCheckElimination::Solve()
+{
+  in.assign(cfg->NumBlocks(), Facts());
+  visited.assign(cfg->NumBlocks(), false);
+  Propagate(cfg->GetEntry(), Facts());
+  while (!worklist.empty()) {
+    BasicBlock *b = worklist.back();
+    worklist.pop_back();
+    Facts s = in[b->id];
+    for (int i = 0; i < b->code.size(); i++) {
+      Transfer(b->code[i], s);
+      CondBranch *cb = dynamic_cast<CondBranch*>(b->code[i]);
+      if (cb && i + 1 < b->code.size())
+        Refine(s, cb, false);           // a check hoisted into a preheader
+    }
+    CondBranch *branch = dynamic_cast<CondBranch*>(b->GetLast());
+    for (int i = 0; i < b->succs.size(); i++) {
+      BasicBlock *to = b->succs[i];
+      Facts out = s;
+      if (branch) {
+        bool isTarget = to->GetLabel() && !strcmp(to->GetLabel(), branch->branch_label());
+        bool isNext = b->id + 1 < cfg->NumBlocks() && cfg->GetBlock(b->id + 1) == to;
+        if (isTarget != isNext)
+          Refine(out, branch, isTarget);
+      }
+      Propagate(to, out);
+    }
+  }
+}
+
+static bool IsPure(Instruction *instr)
+{
+  BinaryOp *op = dynamic_cast<BinaryOp*>(instr);
+  if (op)
+    return op->opcode() != BinaryOp::Div && op->opcode() != BinaryOp::Mod;
+  return dynamic_cast<LoadConstant*>(instr) || dynamic_cast<LoadLabel*>(instr) ||
+         dynamic_cast<LoadStringConstant*>(instr) || dynamic_cast<Assign*>(instr);
+}
+
+/* Method: HoistCheck
+ * ------------------
+ * Moves the check that ends the loop header, and the constants and
+ * length loads in the header that it depends on, to a new preheader.
+ * The check must branch out of the function, its operands must not be
+ * changed anywhere in the loop, and everything before it in the header
+ * must be free of side effects: then the first trip through the header
+ * fails it exactly when the preheader does, and no later one can.
+ */
+bool BoundsCheckElimination::HoistCheck(Loop *loop, CodeGenerator *cg)
+{
+  BasicBlock *h = loop->header;
+  IfCmp *check = dynamic_cast<IfCmp*>(h->GetLast());
+  if (!check || !IsCheck(check) || !h->GetLabel()) return false;
+  for (int i = 0; i < h->succs.size(); i++)
+    if (h->succs[i]->GetLabel() &&
+        !strcmp(h->succs[i]->GetLabel(), check->branch_label()))
+      return false;
+
+  std::map<Location*, int> defs, defsInLoop;
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *block = cfg->GetBlock(b);
+    for (int i = 0; i < block->code.size(); i++) {
+      Location *dst = block->code[i]->GetDst();
+      if (!dst) continue;
+      defs[dst]++;
+      if (loop->Contains(block)) defsInLoop[dst]++;
+    }
+  }
+
+  Location *srcs[Instruction::MaxSources];
+  std::vector<Instruction*> movable;
+  std::set<Location*> invariant;
+  for (int i = 1; i + 1 < h->code.size(); i++) {
+    Instruction *instr = h->code[i];
+    Location *dst = instr->GetDst();
+    int n = instr->GetSources(srcs);
+    bool srcsInvariant = true;
+    for (int j = 0; j < n; j++)
+      if (defsInLoop[srcs[j]] && !invariant.count(srcs[j]))
+        srcsInvariant = false;
+    if (dst && defs[dst] == 1 && srcsInvariant &&
+        (dynamic_cast<LoadConstant*>(instr) || dynamic_cast<Load*>(instr))) {
+      movable.push_back(instr);
+      invariant.insert(dst);
+    } else if (!IsPure(instr))
+      return false;
+  }
+
+  int n = check->GetSources(srcs);
+  std::set<Location*> needed;
+  for (int j = 0; j < n; j++) {
+    if (defsInLoop[srcs[j]] && !invariant.count(srcs[j])) return false;
+    needed.insert(srcs[j]);
+  }
+  std::vector<Instruction*> moved;
+  for (int i = movable.size() - 1; i >= 0; i--) {
+    if (!needed.count(movable[i]->GetDst())) continue;
+    moved.insert(moved.begin(), movable[i]);
+    n = movable[i]->GetSources(srcs);
+    needed.insert(srcs, srcs + n);
+  }
+
+  BasicBlock *pre = cfg->InsertPreheader(loop, cg->NewLabel());
+  if (!pre) return false;
+  moved.push_back(check);
+  for (int i = 0; i < moved.size(); i++) {
+    h->code.erase(std::find(h->code.begin(), h->code.end(), moved[i]));
+    pre->code.push_back(moved[i]);
+  }
+  return true;
+}
+
+void BoundsCheckElimination::HoistChecks(CodeGenerator *cg)
+{
+  const std::vector<Loop*> &loops = cfg->GetLoops();
+  for (int i = 0; i < loops.size(); i++)
+    if (HoistCheck(loops[i], cg))
+      hoisted++;
+}
+
+/* Method: Rewrite
+ * ---------------
+ * Drops the checks found to be in bounds, and then the loads of the
+ * lengths they compared against if nothing else reads them.
+ */
+void BoundsCheckElimination::Rewrite(std::vector<Instruction*> &fn)
+{
+  int removed = 0;
+  std::set<Location*> lengths;
+  std::vector<Instruction*> out;
+  Location *srcs[Instruction::MaxSources];
+
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *block = cfg->GetBlock(b);
+    Facts s = in[b];
+    for (int i = 0; i < block->code.size(); i++) {
+      Instruction *instr = block->code[i];
+      CondBranch *cb = dynamic_cast<CondBranch*>(instr);
+      if (visited[b] && IsCheck(instr)) {
+        instr->GetSources(srcs);
+        if (InBounds(s, srcs[0], srcs[1])) {
+          removed++;
+          lengths.insert(srcs[1]);
+          instr = NULL;
+        }
+      }
+      Transfer(block->code[i], s);
+      if (cb) Refine(s, cb, false);
+      if (instr) out.push_back(instr);
+    }
+  }
+
+  std::set<Location*> used;
+  for (int i = 0; i < out.size(); i++) {
+    int n = out[i]->GetSources(srcs);
+    used.insert(srcs, srcs + n);
+  }
+  fn.clear();
+  for (int i = 0; i < out.size(); i++) {
+    Location *dst = out[i]->GetDst();
+    if (dynamic_cast<Load*>(out[i]) && lengths.count(dst) && !used.count(dst))
+      continue;
+    fn.push_back(out[i]);
+  }
+  PrintDebug("bce", "%d checks removed, %d hoisted", removed, hoisted);
+}
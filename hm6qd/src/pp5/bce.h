@@ -0,0 +1,80 @@
+/* File: bce.h
+ * -----------
+ * The BoundsCheckElimination class removes the array subscript checks
+ * (If i >=u len Goto __ArrayOutOfBounds) of one function that are
+ * sure to pass, using a range analysis over its FlowGraph.
+ *
+ * The analysis tracks simple facts about the fp-relative variables:
+ * v is the constant K, v >= 0, v < K, v < length(a), t holds length(a),
+ * length(a) >= K. Only locals and temps are tracked, as nothing but an
+ * instruction naming one can change it (a call may well change a
+ * global or a field). Loads of the length word, constants, copies,
+ * adding or subtracting a constant and the array allocation sequence
+ * generate facts, and a conditional branch adds the facts its test
+ * implies to each of its two out edges. A fact holds at a block entry
+ * only if it holds along every executed edge into it, so in the loop
+ *
+ *     for (i = 0; i < a.length(); i = i + 1) ... a[i] ...
+ *
+ * i is in range in the body: the loop test bounds it by the length,
+ * it starts non-negative and stepping it by one cannot overflow.
+ *
+ * Before that, a check in a loop header whose operands are loop
+ * invariant, and which every trip through the loop reaches without
+ * doing anything else observable first, is moved (along with the load
+ * of its length) into a preheader, so it runs once per loop entry.
+ */
+
+#ifndef _H_bce
+#define _H_bce
+
+#include <set>
+#include <vector>
+#include "tac.h"
+class FlowGraph;
+class BasicBlock;
+class Loop;
+class CodeGenerator;
+
+class BoundsCheckElimination {
+  private:
+    typedef enum { Const, NonNeg, BelowConst, BelowLen, LenOf,
+                   LenAtLeast, HeaderLen } Kind;
+    struct Fact {
+      Kind kind;
+      Location *var, *array;            // array is NULL if not about one
+      int k;
+      bool operator<(const Fact &f) const;
+    };
+    typedef std::set<Fact> Facts;
+
+    FlowGraph *cfg;
+    std::vector<Facts> in;              // per block, at block entry
+    std::vector<bool> visited;          // per block
+    std::vector<BasicBlock*> worklist;
+    int hoisted;
+
+    static bool IsTracked(Location *var);
+    static bool IsCheck(Instruction *instr);
+    static void Add(Facts &gen, Kind kind, Location *var, Location *array, int k = 0);
+    bool Find(const Facts &s, Kind kind, Location *var, int *k = NULL,
+              Location *array = NULL);
+    void GenAdd(const Facts &s, Location *dst, Location *v, int c, Facts &gen);
+    void Transfer(Instruction *instr, Facts &s);
+    void AssumeLess(Facts &s, Location *x, Location *y, bool strict);
+    void Refine(Facts &s, CondBranch *branch, bool taken);
+    bool InBounds(const Facts &s, Location *subscript, Location *length);
+    void Propagate(BasicBlock *to, const Facts &s);
+    void Solve();
+
+    void HoistChecks(CodeGenerator *cg);
+    bool HoistCheck(Loop *loop, CodeGenerator *cg);
+
+  public:
+    BoundsCheckElimination(FlowGraph *cfg, CodeGenerator *cg);
+
+         // Writes the function's rewritten instructions to fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
@@ -0,0 +1,292 @@
+/* File: cfg.cc
+ * ------------
+ * Implementation of the BasicBlock and FlowGraph classes.
+ */
+
+#include "cfg.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+const char *BasicBlock::GetLabel()
+{
+  Label *l = code.empty() ? NULL : dynamic_cast<Label*>(code.front());
+  return l ? l->text() : NULL;
+}
+
+
+FlowGraph::FlowGraph(std::vector<Instruction*> &fn)
+{
+  Assert(!fn.empty() && dynamic_cast<BeginFunc*>(fn.front()));
+  BuildBlocks(fn);
+  LinkBlocks();
+  std::vector<BasicBlock*> postorder;
+  Number(GetEntry(), postorder);
+  rpo.assign(postorder.rbegin(), postorder.rend());
+  for (int i = 0; i < rpo.size(); i++)
+    rpo[i]->rpoNum = i;
+  ComputeDominators();
+  FindLoops();
+}
+
+FlowGraph::~FlowGraph()
+{
+  for (int i = 0; i < blocks.size(); i++)
+    delete blocks[i];
+  for (int i = 0; i < loops.size(); i++)
+    delete loops[i];
+}
+
+/* Method: BuildBlocks
+ * -------------------
+ * Splits the instructions into maximal straight-line runs. A Label
+ * starts a new block (unless the current one is still empty) and a
+ * Goto, conditional branch, jump table or Return ends the current one.
+ */
+void FlowGraph::BuildBlocks(std::vector<Instruction*> &fn)
+{
+  BasicBlock *cur = NULL;
+  for (int i = 0; i < fn.size(); i++) {
+    Instruction *instr = fn[i];
+    if (!cur || (dynamic_cast<Label*>(instr) && !cur->code.empty())) {
+      cur = new BasicBlock(blocks.size());
+      blocks.push_back(cur);
+    }
+    cur->code.push_back(instr);
+    if (dynamic_cast<Goto*>(instr) || dynamic_cast<CondBranch*>(instr) ||
+        dynamic_cast<JumpTable*>(instr) || dynamic_cast<Return*>(instr))
+      cur = NULL;
+  }
+}
+
+void FlowGraph::AddEdge(BasicBlock *from, BasicBlock *to)
+{
+  from->succs.push_back(to);
+  to->preds.push_back(from);
+}
+
+void FlowGraph::LinkBlocks()
+{
+  std::map<std::string, BasicBlock*> labels;
+  for (int i = 0; i < blocks.size(); i++)
+    if (blocks[i]->GetLabel())
+      labels[blocks[i]->GetLabel()] = blocks[i];
+
+  for (int i = 0; i < blocks.size(); i++) {
+    BasicBlock *b = blocks[i];
+    Instruction *last = b->GetLast();
+    Goto *g = dynamic_cast<Goto*>(last);
+    CondBranch *cb = dynamic_cast<CondBranch*>(last);
+    BasicBlock *target = NULL;
+    if (g && labels.count(g->branch_label()))
+      target = labels[g->branch_label()];
+    if (cb && labels.count(cb->branch_label()))
+      target = labels[cb->branch_label()];
+    if (target)
+      AddEdge(b, target);
+    JumpTable *jt = dynamic_cast<JumpTable*>(last);
+    for (int j = 0; jt && j < jt->branch_labels().size(); j++) {
+      BasicBlock *to = labels[jt->branch_labels()[j]];
+      if (!std::count(b->succs.begin(), b->succs.end(), to))
+        AddEdge(b, to);
+    }
+    if (g || jt || dynamic_cast<Return*>(last) || dynamic_cast<EndFunc*>(last))
+      continue;
+    if (i + 1 < blocks.size() && blocks[i+1] != target)
+      AddEdge(b, blocks[i+1]);
+  }
+}
+
+/* Method: Number
+ * --------------
+ * Depth-first walk from b marking the blocks reached and recording
+ * them in postorder.
+ */
+void FlowGraph::Number(BasicBlock *b, std::vector<BasicBlock*> &postorder)
+{
+  b->reachable = true;
+  for (int i = 0; i < b->succs.size(); i++)
+    if (!b->succs[i]->reachable)
+      Number(b->succs[i], postorder);
+  postorder.push_back(b);
+}
+
+BasicBlock *FlowGraph::Intersect(BasicBlock *b1, BasicBlock *b2)
+{
+  while (b1 != b2) {
+    while (b1->rpoNum > b2->rpoNum) b1 = b1->idom;
+    while (b2->rpoNum > b1->rpoNum) b2 = b2->idom;
+  }
+  return b1;
+}
+
+/* Method: ComputeDominators
+ * -------------------------
+ * "A Simple, Fast Dominance Algorithm" (Cooper, Harvey & Kennedy).
+ * While iterating the entry is temporarily its own idom so that
+ * Intersect terminates; it is reset to NULL at the end.
+ */
+void FlowGraph::ComputeDominators()
+{
+  BasicBlock *entry = GetEntry();
+  entry->idom = entry;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 1; i < rpo.size(); i++) {
+      BasicBlock *b = rpo[i];
+      BasicBlock *newIdom = NULL;
+      for (int j = 0; j < b->preds.size(); j++) {
+        BasicBlock *p = b->preds[j];
+        if (!p->idom) continue;          // unreachable or not yet seen
+        newIdom = newIdom ? Intersect(p, newIdom) : p;
+      }
+      if (newIdom != b->idom) {
+        b->idom = newIdom;
+        changed = true;
+      }
+    }
+  }
+  entry->idom = NULL;
+}
+
+bool FlowGraph::Dominates(BasicBlock *a, BasicBlock *b)
+{
+  if (!a->reachable || !b->reachable) return false;
+  for (; b; b = b->idom)
+    if (b == a) return true;
+  return false;
+}
+
+static bool IsSmaller(Loop *a, Loop *b)
+{
+  return a->blocks.size() < b->blocks.size();
+}
+
+/* Method: FindLoops
+ * -----------------
+ * Collects the natural loop of each back edge, walking predecessors
+ * back from its source until the header. Back edges into the same
+ * header make up one loop. A loop nested in another has fewer blocks,
+ * so sorting by size puts inner loops first.
+ */
+void FlowGraph::FindLoops()
+{
+  std::map<BasicBlock*, Loop*> byHeader;
+  for (int i = 0; i < rpo.size(); i++) {
+    BasicBlock *b = rpo[i];
+    for (int j = 0; j < b->succs.size(); j++) {
+      BasicBlock *h = b->succs[j];
+      if (!Dominates(h, b)) continue;
+      Loop *loop = byHeader[h];
+      if (!loop) {
+        loop = byHeader[h] = new Loop(h);
+        loops.push_back(loop);
+      }
+      loop->latches.push_back(b);
+      std::vector<BasicBlock*> work(1, b);
+      while (!work.empty()) {
+        BasicBlock *w = work.back();
+        work.pop_back();
+        if (loop->Contains(w)) continue;
+        loop->blocks.insert(w);
+        for (int k = 0; k < w->preds.size(); k++)
+          if (w->preds[k]->reachable)
+            work.push_back(w->preds[k]);
+      }
+    }
+  }
+  std::stable_sort(loops.begin(), loops.end(), IsSmaller);
+}
+
+/* Method: InsertPreheader
+ * -----------------------
+ * A new block only holds a Label, and takes over the header's edge
+ * from the block before it (and its place in the dominator tree and
+ * the reverse postorder). It belongs to every loop around this one.
+ */
+BasicBlock *FlowGraph::InsertPreheader(Loop *loop, const char *label)
+{
+  if (loop->preheader) return loop->preheader;
+  BasicBlock *header = loop->header;
+  if (header->id == 0 || !header->GetLabel()) return NULL;
+  BasicBlock *prev = blocks[header->id - 1];
+  if (loop->Contains(prev) ||
+      !std::count(header->preds.begin(), header->preds.end(), prev))
+    return NULL;
+  for (int i = 0; i < header->preds.size(); i++)
+    if (header->preds[i] != prev && !loop->Contains(header->preds[i]))
+      return NULL;                       // entered by a jump
+  Goto *g = dynamic_cast<Goto*>(prev->GetLast());
+  CondBranch *cb = dynamic_cast<CondBranch*>(prev->GetLast());
+  if ((g && !strcmp(g->branch_label(), header->GetLabel())) ||
+      (cb && !strcmp(cb->branch_label(), header->GetLabel())) ||
+      dynamic_cast<JumpTable*>(prev->GetLast()))
+    return NULL;
+  if (prev->succs.size() == 1)
+    return loop->preheader = prev;
+
+  BasicBlock *pre = new BasicBlock(header->id);
+  pre->code.push_back(new Label(label));
+  blocks.insert(blocks.begin() + header->id, pre);
+  for (int i = pre->id + 1; i < blocks.size(); i++)
+    blocks[i]->id = i;
+  *std::find(prev->succs.begin(), prev->succs.end(), header) = pre;
+  *std::find(header->preds.begin(), header->preds.end(), prev) = pre;
+  pre->preds.push_back(prev);
+  pre->succs.push_back(header);
+
+  pre->reachable = header->reachable;
+  if (header->reachable) {
+    pre->idom = header->idom;
+    header->idom = pre;
+    rpo.insert(rpo.begin() + header->rpoNum, pre);
+    for (int i = 0; i < rpo.size(); i++)
+      rpo[i]->rpoNum = i;
+  }
+  for (int i = 0; i < loops.size(); i++)
+    if (loops[i] != loop && loops[i]->Contains(header))
+      loops[i]->blocks.insert(pre);
+  loop->preheader = pre;
+  return pre;
+}
+
+void FlowGraph::Flatten(std::vector<Instruction*> &fn)
+{
+  fn.clear();
+  for (int i = 0; i < blocks.size(); i++)
+    fn.insert(fn.end(), blocks[i]->code.begin(), blocks[i]->code.end());
+}
+
+static std::string BlockList(const std::vector<BasicBlock*> &list)
+{
+  std::string s;
+  char buf[16];
+  for (int i = 0; i < list.size(); i++) {
+    sprintf(buf, " B%d", list[i]->id);
+    s += buf;
+  }
+  return s.empty() ? " -" : s;
+}
+
+void FlowGraph::Print()
+{
+  if (!IsDebugOn("cfg")) return;
+  for (int i = 0; i < blocks.size(); i++) {
+    BasicBlock *b = blocks[i];
+    char idom[16] = "-";
+    if (b->idom) sprintf(idom, "B%d", b->idom->id);
+    PrintDebug("cfg", "B%d%s preds:%s succs:%s idom: %s", b->id,
+               b->reachable ? "" : " (unreachable)",
+               BlockList(b->preds).c_str(), BlockList(b->succs).c_str(), idom);
+    for (int j = 0; j < b->code.size(); j++)
+      b->code[j]->Print();
+  }
+  for (int i = 0; i < loops.size(); i++) {
+    std::vector<BasicBlock*> body;
+    for (int j = 0; j < blocks.size(); j++)
+      if (loops[i]->Contains(blocks[j])) body.push_back(blocks[j]);
+    PrintDebug("cfg", "loop B%d:%s", loops[i]->header->id, BlockList(body).c_str());
+  }
+}
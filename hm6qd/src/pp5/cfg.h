@@ -0,0 +1,108 @@
+/* File: cfg.h
+ * -----------
+ * The FlowGraph class partitions the Tac instructions of one function
+ * (BeginFunc through EndFunc) into basic blocks and links them into a
+ * control-flow graph, the structure the optimization passes work on.
+ *
+ * A new block starts at the first instruction, at every Label, and
+ * after every Goto, conditional branch (IfZ/IfCmp), JumpTable and
+ * Return. A block ending in Goto has its target as only successor, one
+ * ending in a conditional branch has the target and the fall-through
+ * block, one ending in a JumpTable each of the labels in its table,
+ * one ending in Return or EndFunc has none, and any other block falls
+ * through to the next. A branch to a label outside the function can
+ * only be to a run-time error stub, which never returns, so it adds no
+ * edge.
+ *
+ * Blocks not reachable from the entry are kept (a pass may delete them)
+ * but take no part in the dominator computation. Dominators are found
+ * with the iterative algorithm of Cooper, Harvey and Kennedy over the
+ * reverse postorder of the reachable blocks.
+ *
+ * An edge whose target dominates its source is a back edge, and the
+ * natural loop of a header is the header plus every block that reaches
+ * one of its back edges without going through it. A pass that wants to
+ * move code out of a loop can ask for a preheader, a new block on the
+ * single entry edge into the header.
+ */
+
+#ifndef _H_cfg
+#define _H_cfg
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "tac.h"
+
+class BasicBlock {
+  public:
+    int id;                             // index into the graph's blocks
+    std::vector<Instruction*> code;
+    std::vector<BasicBlock*> preds, succs;
+    bool reachable;
+    BasicBlock *idom;                   // NULL for entry and unreachable
+    int rpoNum;                         // -1 if unreachable
+
+    BasicBlock(int n) : id(n), reachable(false), idom(NULL), rpoNum(-1) {}
+
+         // Text of the Label that starts the block, or NULL if none
+    const char *GetLabel();
+    Instruction *GetLast() { return code.empty() ? NULL : code.back(); }
+};
+
+class Loop {
+  public:
+    BasicBlock *header;
+    std::set<BasicBlock*> blocks;       // including the header
+    std::vector<BasicBlock*> latches;   // sources of the back edges
+    BasicBlock *preheader;              // NULL until one is inserted
+
+    Loop(BasicBlock *h) : header(h), preheader(NULL) { blocks.insert(h); }
+    bool Contains(BasicBlock *b) { return blocks.count(b) > 0; }
+};
+
+class FlowGraph {
+  private:
+    std::vector<BasicBlock*> blocks;
+    std::vector<BasicBlock*> rpo;       // reachable blocks, reverse postorder
+    std::vector<Loop*> loops;           // innermost first
+
+    void BuildBlocks(std::vector<Instruction*> &fn);
+    void LinkBlocks();
+    void AddEdge(BasicBlock *from, BasicBlock *to);
+    void Number(BasicBlock *b, std::vector<BasicBlock*> &postorder);
+    void ComputeDominators();
+    BasicBlock *Intersect(BasicBlock *b1, BasicBlock *b2);
+    void FindLoops();
+
+  public:
+    FlowGraph(std::vector<Instruction*> &fn);
+    ~FlowGraph();
+
+    int NumBlocks()                     { return blocks.size(); }
+    BasicBlock *GetBlock(int i)         { return blocks[i]; }
+    BasicBlock *GetEntry()              { return blocks.front(); }
+    const std::vector<BasicBlock*> &GetReversePostorder() { return rpo; }
+    const std::vector<Loop*> &GetLoops() { return loops; }
+
+         // True if every path from the entry to b passes through a
+         // (so a block dominates itself). False if b is unreachable.
+    bool Dominates(BasicBlock *a, BasicBlock *b);
+
+         // Returns the loop's preheader. That is the block before the
+         // header if its one way out is to fall into it, otherwise a new
+         // block is made just before the header under the given label.
+         // Only possible when the one way into the loop is to fall
+         // through into the header from the block before it; returns
+         // NULL otherwise.
+    BasicBlock *InsertPreheader(Loop *loop, const char *label);
+
+         // Writes the instructions of all blocks, in block order, to fn
+    void Flatten(std::vector<Instruction*> &fn);
+
+         // Dumps the blocks and their edges when -d cfg is on
+    void Print();
+};
+
+#endif
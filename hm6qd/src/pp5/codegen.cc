@@ -0,0 +1,688 @@
+/* File: codegen.cc
+ * ----------------
+ * Implementation for the CodeGenerator class. The methods don't do anything
+ * too fancy, mostly just create objects of the various Tac instruction
+ * classes and append them to the list.
+ */
+
+#include "codegen.h"
+#include <string.h>
+#include "tac.h"
+#include "mips.h"
+#include "cfg.h"
+#include "liveness.h"
+#include "sccp.h"
+#include "bce.h"
+#include "licm.h"
+#include "lvn.h"
+#include "copyprop.h"
+#include "dce.h"
+#include "ssa.h"
+#include "inliner.h"
+#include "tailcall.h"
+#include "interp.h"
+#include "errors.h"
+
+Location* CodeGenerator::ThisPtr= new Location(fpRelative, 4, "this");
+  
+CodeGenerator::CodeGenerator()
+{
+  gp=0;
+  for (int i = 0; i < NumRuntimeErrors; i++)
+    errorStubUsed[i] = false;
+}
+
+char *CodeGenerator::NewLabel()
+{
+  static int nextLabelNum = 0;
+  char temp[10];
+  sprintf(temp, "_L%d", nextLabelNum++);
+  return strdup(temp);
+}
+
+Location *CodeGenerator::GenLocalVar(const char* name)
+{
+  Location *result = new Location(fpRelative, OffsetToFirstLocal - LocalTempNum * VarSize, name);
+  // printf("CodeGenerator::GenLocalVar, new Location(fpRelative, %d, %s);\n",OffsetToFirstLocal - LocalTempNum * VarSize, name);
+  LocalTempNum++;
+  return result;
+}
+
+Location *CodeGenerator::GenTempVar()
+{
+  static int nextTempNum;
+  char temp[10];
+  sprintf(temp, "_tmp%d", nextTempNum);
+  /* pp5: need to create variable in proper location
+     in stack frame for use as temporary. Until you
+     do that, the assert below will always fail to remind
+     you this needs to be implemented  */
+  Location *result = new Location(fpRelative, OffsetToFirstLocal - LocalTempNum * VarSize, temp);
+  // printf("CodeGenerator::GenTempVar, new Location(fpRelative, %d, _tmp%d);\n",OffsetToFirstLocal - LocalTempNum * VarSize, nextTempNum);
+  nextTempNum++;
+  LocalTempNum++;
+  Assert(result != NULL);
+  return result;
+}
+
+Location *CodeGenerator::GenGlobalVar(const char *name, bool isPointer)
+{
+    if (isPointer) globalPointers.push_back(gp);
+    gp+=VarSize;
+    return new Location(gpRelative, gp-4, name);
+}
+
+Location *CodeGenerator::GenLoadConstant(int value)
+{
+  Location *result = GenTempVar();
+  code.push_back(new LoadConstant(result, value));
+  return result;
+}
+
+Location *CodeGenerator::GenLoadConstant(const char *s)
+{
+  Location *result = GenTempVar();
+  code.push_back(new LoadStringConstant(result, s, InternString(s)));
+  return result;
+} 
+
+/* Method: InternString
+ * --------------------
+ * Literals from the scanner come with their quotes and the run-time
+ * error messages without, so the key is the quoted form either way.
+ */
+const char *CodeGenerator::InternString(const char *s)
+{
+  std::string str = (*s == '"') ? s : std::string("\"") + s + "\"";
+  std::map<std::string, const char*>::iterator it = stringLabels.find(str);
+  if (it != stringLabels.end())
+    return it->second;
+  char label[32];
+  snprintf(label, sizeof label, "_string%d", (int)stringPool.size() + 1);
+  const char *l = strdup(label);
+  stringLabels[str] = l;
+  stringPool.push_back(std::make_pair(l, strdup(str.c_str())));
+  return l;
+}
+
+Location *CodeGenerator::GenLoadLabel(const char *label)
+{
+  Location *result = GenTempVar();
+  code.push_back(new LoadLabel(result, label));
+  return result;
+} 
+
+
+void CodeGenerator::GenAssign(Location *dst, Location *src)
+{
+  code.push_back(new Assign(dst, src));
+}
+
+
+Location *CodeGenerator::GenLoad(Location *ref, int offset, bool readOnly)
+{
+  Location *result = GenTempVar();
+  code.push_back(new Load(result, ref, offset, readOnly));
+  return result;
+}
+
+void CodeGenerator::GenStore(Location *dst,Location *src, int offset)
+{
+  code.push_back(new Store(dst, src, offset));
+}
+
+
+Location *CodeGenerator::GenBinaryOp(const char *opName, Location *op1,
+						     Location *op2)
+{
+  Location *result = GenTempVar();
+  code.push_back(new BinaryOp(BinaryOp::OpCodeForName(opName), result, op1, op2));
+  return result;
+}
+
+void CodeGenerator::GenIncrement(Location *var, int delta)
+{
+  Location *c = GenLoadConstant(delta);
+  code.push_back(new BinaryOp(BinaryOp::Add, var, var, c));
+}
+
+
+void CodeGenerator::GenLabel(const char *label)
+{
+  code.push_back(new Label(label));
+}
+
+void CodeGenerator::GenIfZ(Location *test, const char *label)
+{
+  code.push_back(new IfZ(test, label));
+}
+
+void CodeGenerator::GenIfCmp(BinaryOp::OpCode rel, Location *op1,
+                             Location *op2, const char *label)
+{
+  code.push_back(new IfCmp(rel, op1, op2, label));
+}
+
+/* Method: GenSwitch
+ * -----------------
+ * A run of at least MinJumpTableCases case values that fills at least
+ * half the range from its least to its greatest value is dense: it
+ * gets a jump table over that range, whose holes go to the default,
+ * behind a single unsigned compare of the offset into it, which catches
+ * values on either side. The offset is taken with a subtraction that
+ * wraps, as the value may be anything. Otherwise the cases are split in half by value
+ * and each half dispatched on its own, so a sparse switch becomes a
+ * balanced tree of compares that takes O(log n) of them to reach the
+ * few cases left at a leaf, which are tested one by one.
+ */
+static const int MinJumpTableCases = 4;
+static const int MaxLinearCases = 3;
+
+void CodeGenerator::GenSwitch(Location *value, const std::vector<std::pair<int, const char*> > &cases,
+                              const char *defaultLabel)
+{
+  GenCaseTree(value, cases, 0, cases.size(), defaultLabel);
+}
+
+void CodeGenerator::GenCaseTree(Location *value, const std::vector<std::pair<int, const char*> > &cases,
+                                int lo, int hi, const char *defaultLabel)
+{
+  int n = hi - lo;
+  long long low = cases[lo].first, span = cases[hi-1].first - low + 1;
+  if (n >= MinJumpTableCases && span <= 2 * n) {
+    Location *index = low ? GenBinaryOp("-u", value, GenLoadConstant(low)) : value;
+    GenIfCmp(BinaryOp::UnsignedGreaterEq, index, GenLoadConstant(span), defaultLabel);
+    std::vector<const char*> labels(span, defaultLabel);
+    for (int i = lo; i < hi; i++)
+      labels[cases[i].first - low] = cases[i].second;
+    code.push_back(new JumpTable(index, NewLabel(), labels));
+  } else if (n <= MaxLinearCases) {
+    for (int i = lo; i < hi; i++)
+      GenIfCmp(BinaryOp::Eq, value, GenLoadConstant(cases[i].first), cases[i].second);
+    GenGoto(defaultLabel);
+  } else {
+    int mid = lo + n / 2;
+    char *upper = NewLabel();
+    GenIfCmp(BinaryOp::GreaterEq, value, GenLoadConstant(cases[mid].first), upper);
+    GenCaseTree(value, cases, lo, mid, defaultLabel);
+    GenLabel(upper);
+    GenCaseTree(value, cases, mid, hi, defaultLabel);
+  }
+}
+
+void CodeGenerator::GenGoto(const char *label)
+{
+  code.push_back(new Goto(label));
+}
+
+void CodeGenerator::GenReturn(Location *val)
+{
+  code.push_back(new Return(val));
+}
+
+
+BeginFunc *CodeGenerator::GenBeginFunc()
+{
+  BeginFunc *result = new BeginFunc;
+  code.push_back(result);
+  return result;
+}
+
+void CodeGenerator::GenEndFunc()
+{
+  code.push_back(new EndFunc());
+}
+
+void CodeGenerator::GenPushParam(Location *param)
+{
+  code.push_back(new PushParam(param));
+}
+
+void CodeGenerator::GenPopParams(int numBytesOfParams)
+{
+  Assert(numBytesOfParams >= 0 && numBytesOfParams % VarSize == 0); // sanity check
+  if (numBytesOfParams > 0)
+    code.push_back(new PopParams(numBytesOfParams));
+}
+
+Location *CodeGenerator::GenLCall(const char *label, bool fnHasReturnValue)
+{
+  Location *result = fnHasReturnValue ? GenTempVar() : NULL;
+  code.push_back(new LCall(label, result));
+  return result;
+}
+
+Location *CodeGenerator::GenACall(Location *fnAddr, bool fnHasReturnValue)
+{
+  Location *result = fnHasReturnValue ? GenTempVar() : NULL;
+  code.push_back(new ACall(fnAddr, result));
+  return result;
+}
+ 
+ 
+static struct _builtin {
+  const char *label;
+  int numArgs;
+  bool hasReturn;
+} builtins[] =
+ {{"_Alloc", 1, true},
+  {"_ReadLine", 0, true},
+  {"_ReadInteger", 0, true},
+  {"_StringEqual", 2, true},
+  {"_PrintInt", 1, false},
+  {"_PrintString", 1, false},
+  {"_PrintBool", 1, false},
+  {"_Halt", 0, false}};
+
+Location *CodeGenerator::GenBuiltInCall(BuiltIn bn,Location *arg1, Location *arg2)
+{
+  Assert(bn >= 0 && bn < NumBuiltIns);
+  struct _builtin *b = &builtins[bn];
+  Location *result = NULL;
+
+  if (b->hasReturn) result = GenTempVar();
+                // verify appropriate number of non-NULL arguments given
+  Assert((b->numArgs == 0 && !arg1 && !arg2)
+	|| (b->numArgs == 1 && arg1 && !arg2)
+	|| (b->numArgs == 2 && arg1 && arg2));
+  if (arg2) code.push_back(new PushParam(arg2));
+  if (arg1) code.push_back(new PushParam(arg1));
+  code.push_back(new LCall(b->label, result));
+  GenPopParams(VarSize*b->numArgs);
+  return result;
+}
+
+bool CodeGenerator::IsBuiltIn(const char *label)
+{
+  for (int i = 0; i < NumBuiltIns; i++)
+    if (!strcmp(builtins[i].label, label)) return true;
+  return false;
+}
+
+
+void CodeGenerator::GenVTable(const char *className, List<const char *> *methodLabels,
+                              const std::vector<int> &pointerFields)
+{
+  code.push_back(new VTable(className, methodLabels, pointerFields));
+}
+
+
+/* Method: PackFrameSlots
+ * -----------------------
+ * GenLocalVar and GenTempVar give every variable a slot of its own. Here
+ * the locals/temps of a function that did not get a register are packed
+ * into as few slots as possible: visiting the live intervals in order of
+ * start, a variable reuses the slot of any variable whose interval has
+ * already ended. The Locations are updated in place and the BeginFunc
+ * frame size shrinks to match. Params keep their caller-assigned slots.
+ */
+void CodeGenerator::PackFrameSlots(std::vector<Instruction*> &fn,
+                                   Liveness *liveness, Mips *mips)
+{
+  const std::vector<LiveInterval*> &intervals = liveness->GetIntervals();
+  std::vector<std::pair<int, int> > active; // (end of interval, slot)
+  std::vector<int> freeSlots;
+  int numSlots = 0;
+
+  for (int i = 0; i < intervals.size(); i++) {
+    LiveInterval *cur = intervals[i];
+    if (cur->var->GetOffset() >= 0 || mips->IsInRegister(cur->var))
+      continue;
+    for (int j = active.size() - 1; j >= 0; j--)
+      if (active[j].first < cur->start) {
+        freeSlots.push_back(active[j].second);
+        active.erase(active.begin() + j);
+      }
+    int slot;
+    if (freeSlots.empty())
+      slot = numSlots++;
+    else {
+      slot = freeSlots.back();
+      freeSlots.pop_back();
+    }
+    cur->var->SetOffset(OffsetToFirstLocal - slot * VarSize);
+    active.push_back(std::make_pair(cur->end, slot));
+  }
+  BeginFunc *begin = dynamic_cast<BeginFunc*>(fn.front());
+  Assert(begin);
+  begin->SetFrameSize(numSlots * VarSize);
+}
+
+/* Method: NumberArgs
+ * ------------------
+ * Tells each PushParam of fn which arg of its call it is, counting from
+ * the one pushed last, and whether the call passes args in registers,
+ * as all but the calls to built-ins do. Only the args after the first
+ * Mips::NumArgRegs of those then go on the stack, so the PopParams is
+ * changed to pop just them. The pushes of a call are always the
+ * instructions right before it.
+ */
+void CodeGenerator::NumberArgs(std::vector<Instruction*> &fn)
+{
+  std::vector<Instruction*> out;
+  for (int i = 0; i < fn.size(); i++) {
+    out.push_back(fn[i]);
+    if (!fn[i]->IsCall() || dynamic_cast<TailCall*>(fn[i])) continue;
+    LCall *lcall = dynamic_cast<LCall*>(fn[i]);
+    bool viaRegs = !lcall || !IsBuiltIn(lcall->function_label());
+    int numArgs = 0;
+    while (numArgs < i && dynamic_cast<PushParam*>(fn[i - 1 - numArgs]))
+      numArgs++;
+    for (int k = 0; k < numArgs; k++)
+      dynamic_cast<PushParam*>(fn[i - 1 - k])->SetSlot(k, numArgs, viaRegs);
+    PopParams *pop = i + 1 < fn.size() ? dynamic_cast<PopParams*>(fn[i+1]) : NULL;
+    Assert(numArgs * VarSize == (pop ? pop->GetNumBytes() : 0));
+    int onStack = viaRegs ? numArgs - Mips::NumArgRegs : numArgs;
+    if (pop) {
+      if (onStack > 0)
+        out.push_back(onStack == numArgs ? pop : new PopParams(onStack * VarSize));
+      i++;
+    }
+  }
+  fn = out;
+}
+
+/* Method: SelectImmediates
+ * -------------------------
+ * Rewrites x + c and x - c, where c was loaded with a constant that
+ * fits in 16 bits, as an AddImm, then drops the loads of constants
+ * that nothing reads any more. Only a constant loaded earlier in the
+ * same block counts, and only into a frame variable, which no call
+ * can change: nothing can jump in between load and use, so c is
+ * known to still hold it.
+ */
+void CodeGenerator::SelectImmediates(std::vector<Instruction*> &fn)
+{
+  std::map<Location*, int> constants;   // known values, in this block
+  std::map<Location*, int> uses;
+  Location *srcs[Instruction::MaxSources];
+  for (int i = 0; i < fn.size(); i++) {
+    BinaryOp *op = dynamic_cast<BinaryOp*>(fn[i]);
+    LoadConstant *lc = dynamic_cast<LoadConstant*>(fn[i]);
+    if (dynamic_cast<Label*>(fn[i]))
+      constants.clear();
+    if (op && (op->opcode() == BinaryOp::Add || op->opcode() == BinaryOp::Sub)) {
+      op->GetSources(srcs);
+      bool isAdd = op->opcode() == BinaryOp::Add;
+      if (isAdd && constants.count(srcs[0]) && !constants.count(srcs[1]))
+        std::swap(srcs[0], srcs[1]);
+      if (constants.count(srcs[1])) {
+        int c = constants[srcs[1]];
+        int imm = isAdd ? c : -c;
+        if (c > AddImm::MinImm && c <= AddImm::MaxImm)
+          fn[i] = new AddImm(op->GetDst(), srcs[0], imm);
+      }
+    }
+    int n = fn[i]->GetSources(srcs);
+    for (int j = 0; j < n; j++)
+      uses[srcs[j]]++;
+    if (fn[i]->GetDst())
+      constants.erase(fn[i]->GetDst());
+    if (lc && lc->GetDst()->GetSegment() == fpRelative)
+      constants[lc->GetDst()] = lc->value();
+  }
+  std::vector<Instruction*> out;
+  for (int i = 0; i < fn.size(); i++) {
+    LoadConstant *lc = dynamic_cast<LoadConstant*>(fn[i]);
+    if (lc && lc->GetDst()->GetSegment() == fpRelative && !uses[lc->GetDst()])
+      continue;
+    out.push_back(fn[i]);
+  }
+  fn = out;
+}
+
+bool CodeGenerator::IsLeafFunction(std::vector<Instruction*> &fn)
+{
+  for (int i = 0; i < fn.size(); i++)
+    if (fn[i]->IsCall())
+      return false;
+  return true;
+}
+
+void CodeGenerator::OptimizeFunction(std::vector<Instruction*> &fn, const char *fnLabel)
+{
+  if (OptimizationLevel() < 1) return;
+  TailCallElimination tce(this, fnLabel);
+  tce.Rewrite(fn);
+  {
+    FlowGraph cfg(fn);
+    ConstantPropagation sccp(&cfg);
+    sccp.Rewrite(fn);
+  }
+  {
+    FlowGraph cfg(fn);
+    BoundsCheckElimination bce(&cfg, this);
+    bce.Rewrite(fn);
+  }
+  {
+    FlowGraph cfg(fn);
+    LoopInvariantCodeMotion licm(&cfg, this);
+    licm.Rewrite(fn);
+  }
+  {
+    FlowGraph cfg(fn);
+    ValueNumbering lvn(&cfg);
+    lvn.Rewrite(fn);
+  }
+  {
+    FlowGraph cfg(fn);
+    CopyPropagation copyprop(&cfg);
+    copyprop.Rewrite(fn);
+  }
+  DeadCodeElimination dce;
+  dce.Rewrite(fn);
+  {
+    FlowGraph cfg(fn);
+    SSAForm ssa(&cfg, this);
+    ssa.Destroy(fn);
+  }
+}
+
+void CodeGenerator::DoFinalCodeGen()
+{
+  GenRuntimeErrorStubs();
+  Inliner inliner(this, OptimizationLevel());
+  inliner.Rewrite(code);
+
+  Mips mips;
+  bool printTac = IsDebugOn("tac"); // if debug don't translate to mips, just print Tac
+  bool run = IsDebugOn("run");      // or run it here instead
+  TacInterpreter interp(stringPool, gp);
+  if (!printTac && !run)
+    mips.EmitPreamble();
+
+  // Each function body is analyzed as a unit so its variables can be
+  // assigned registers and frame slots before any of it is emitted.
+  std::list<Instruction*>::iterator p;
+  const char *fnLabel = NULL;     // the label just before BeginFunc
+  for (p= code.begin(); p != code.end(); ++p) {
+    std::vector<Instruction*> fn;
+    if (dynamic_cast<Label*>(*p))
+      fnLabel = dynamic_cast<Label*>(*p)->text();
+    if (dynamic_cast<BeginFunc*>(*p)) {
+      for (; !dynamic_cast<EndFunc*>(*p); ++p)
+        fn.push_back(*p);
+      fn.push_back(*p);
+      OptimizeFunction(fn, fnLabel);
+      if (IsDebugOn("cfg")) {
+        FlowGraph cfg(fn);
+        cfg.Print();
+      }
+      SelectImmediates(fn);
+      if (run) {
+        interp.AddFunction(fnLabel, fn);
+        continue;
+      }
+      Liveness liveness(fn);
+      mips.AllocateRegisters(liveness.GetIntervals());
+      PackFrameSlots(fn, &liveness, &mips);
+      mips.SetLeafFunction(OptimizationLevel() >= 1 && IsLeafFunction(fn));
+      NumberArgs(fn);
+    } else if (run) {
+      if (dynamic_cast<VTable*>(*p))
+        interp.AddVTable(dynamic_cast<VTable*>(*p));
+      continue;
+    } else
+      fn.push_back(*p);
+    for (int i = 0; i < fn.size(); i++) {
+      if (printTac)
+        fn[i]->Print();
+      else
+        fn[i]->Emit(&mips);
+    }
+  }
+  if (run)
+    interp.Run();
+  else if (!printTac) {
+    mips.EmitStringPool(stringPool);
+    mips.EmitGlobalPointerMap(globalPointers);
+  }
+}
+
+static struct _errorstub {
+  const char *label, *message;
+} errorStubs[NumRuntimeErrors] = {
+  {"__ArrayOutOfBounds", err_arr_out_of_bounds},
+  {"__ArrayBadSize", err_arr_bad_size},
+};
+
+const char *CodeGenerator::RuntimeErrorLabel(RuntimeError err)
+{
+  Assert(err >= 0 && err < NumRuntimeErrors);
+  errorStubUsed[err] = true;
+  return errorStubs[err].label;
+}
+
+/* Method: GenRuntimeErrorStubs
+ * ----------------------------
+ * Each stub is laid out as a function of its own that the failing
+ * checks branch (not call) into. Its labels start with "__", which no
+ * function label derived from a Decaf identifier can.
+ */
+void CodeGenerator::GenRuntimeErrorStubs()
+{
+  for (int i = 0; i < NumRuntimeErrors; i++) {
+    if (!errorStubUsed[i]) continue;
+    GenLabel(errorStubs[i].label);
+    LocalTempNum = 0;
+    BeginFunc *f = GenBeginFunc();
+    GenMessage(errorStubs[i].message);
+    GenBuiltInCall(Halt, NULL);
+    f->SetFrameSize(LocalTempNum * VarSize);
+    GenEndFunc();
+  }
+}
+
+Location *CodeGenerator::GenNewArray(Location *numElems, bool pointerElems)
+{
+  Location *zero = GenLoadConstant(0);
+  GenIfCmp(BinaryOp::Less, numElems, zero, RuntimeErrorLabel(ArrayBadSize));
+ 
+  Location *arraySize = GenLoadConstant(1);
+  Location *num = GenBinaryOp("+", arraySize, numElems);
+  Location *four = GenLoadConstant(VarSize);
+  Location *bytes = GenBinaryOp("*", num, four);
+  Location *kind = GenLoadConstant(pointerElems ? PointerArray : RawBlock);
+  Location *header = GenBinaryOp("+", bytes, kind);
+  Location *result = GenBuiltInCall(Alloc, header);
+  GenStore(result, numElems);
+  return GenBinaryOp("+", result, four);
+}
+
+Location *CodeGenerator::GenArrayLen(Location *array)
+{
+  return GenLoad(array, -4, true);
+}
+
+Location* CodeGenerator::GenArrayAccess(Location* base, Location* subscript){
+  // As unsigned numbers, negative subscripts are past any array size
+  Location *size = GenLoad(base, -4, true);
+  GenIfCmp(BinaryOp::UnsignedGreaterEq, subscript, size,
+           RuntimeErrorLabel(ArrayOutOfBounds));
+
+  Location *four = GenLoadConstant(VarSize);
+  Location *offBytes = GenBinaryOp("*", four, subscript);
+  Location *addr = GenBinaryOp("+", base, offBytes);
+  // Location *result = GenStore(addr, ); //?
+  return addr;
+}
+
+void CodeGenerator::GenMessage(const char *message)
+{
+   Location *msg = GenLoadConstant(message);
+   GenBuiltInCall(PrintString, msg);
+}
+
+/* Method: GenBumpAlloc
+ * ---------------------
+ * The fast path of _Alloc (see defs.asm): the object goes at _HeapNext,
+ * its header just before it, and _HeapNext moves past it, unless that
+ * would pass _HeapEnd, the word after. Then _Alloc is called to find
+ * more room. The usual case is a taken branch and no call.
+ */
+Location *CodeGenerator::GenBumpAlloc(Location *header, int bytes)
+{
+  const char *fast = NewLabel(), *done = NewLabel();
+  Location *heap = GenLoadLabel("_HeapNext");
+  Location *result = GenLoad(heap);
+  Location *blockSize = GenLoadConstant(bytes + VarSize);
+  Location *next = GenBinaryOp("+", result, blockSize);
+  Location *end = GenLoad(heap, VarSize);
+  GenIfCmp(BinaryOp::UnsignedGreaterEq, end, next, fast);
+  GenAssign(result, GenBuiltInCall(Alloc, header));
+  GenGoto(done);
+  GenLabel(fast);
+  GenStore(heap, next);
+  GenStore(result, header, -VarSize);
+  GenLabel(done);
+  return result;
+}
+
+Location *CodeGenerator::GenNew(const char *vTableLabel, int instanceSize)
+{
+  int bytes = instanceSize + VarSize; // + vptr
+  Location *header = GenLoadConstant(bytes | ObjectBlock);
+  Location *result;
+  if (OptimizationLevel() >= 1)
+    result = GenBumpAlloc(header, bytes);
+  else
+    result = GenBuiltInCall(Alloc, header);
+  Location *vt = GenLoadLabel(vTableLabel);
+  GenStore(result, vt);
+  return result;
+}
+
+
+Location *CodeGenerator::GenDynamicDispatch(Location *rcvr, int vtableOffset, List<Location*> *args, bool hasReturnValue)
+{
+  Location *vptr = GenLoad(rcvr, 0, true);
+  Assert(vtableOffset >= 0);
+  Location *m = GenLoad(vptr, vtableOffset*4, true);
+  return GenMethodCall(rcvr, m, args, hasReturnValue);
+}
+
+Location *CodeGenerator::GenMethodCall(Location *rcvr, Location *meth, List<Location*> *args, bool fnHasReturnValue)
+{
+  for (int i = args->NumElements()-1; i >= 0; i--)
+    GenPushParam(args->Nth(i));
+  GenPushParam(rcvr);        
+  Location *result= GenACall(meth, fnHasReturnValue);
+  GenPopParams((args->NumElements()+1)*VarSize);
+  return result;
+}
+
+/* Method: GenStaticDispatch
+ * -------------------------
+ * A method call whose target is known at compile time: the receiver is
+ * passed as the first param as usual, but the method is called by its
+ * label rather than through the receiver's vtable.
+ */
+Location *CodeGenerator::GenStaticDispatch(Location *rcvr, const char *methodLabel, List<Location*> *args, bool hasReturnValue)
+{
+  for (int i = args->NumElements()-1; i >= 0; i--)
+    GenPushParam(args->Nth(i));
+  GenPushParam(rcvr);
+  Location *result = GenLCall(methodLabel, hasReturnValue);
+  GenPopParams((args->NumElements()+1)*VarSize);
+  return result;
+}
\ No newline at end of file
@@ -0,0 +1,268 @@
+/* File: codegen.h
+ * ---------------
+ * The CodeGenerator class defines an object that will build Tac
+ * instructions (using the Tac class and its subclasses) and store the
+ * instructions in a sequential list, ready for further processing or
+ * translation to MIPS as part of final code generation.
+ *
+ *    pp5:  The class as given supports the basic Tac instructions,
+ *          you will need to extend it to handle the more complex
+ *          operations (accessing instance variables, dynamic method
+ *          dispatch, array length(), etc.)
+ */
+
+#ifndef _H_codegen
+#define _H_codegen
+
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tac.h"
+class Liveness;
+class Mips;
+
+              // These codes are used to identify the built-in functions
+typedef enum { Alloc, ReadLine, ReadInteger, StringEqual,
+               PrintInt, PrintString, PrintBool, Halt, NumBuiltIns } BuiltIn;
+
+              // The run-time checks that can fail. Each has one shared
+              // stub that prints the error message and halts.
+typedef enum { ArrayOutOfBounds, ArrayBadSize, NumRuntimeErrors } RuntimeError;
+
+              // What the collector finds in a heap block, kept in the
+              // low bits of its header (see defs.asm)
+typedef enum { FreeBlock, RawBlock, PointerArray, ObjectBlock } HeapBlockKind;
+
+class CodeGenerator {
+  private:
+    std::list<Instruction*> code;
+    int gp;
+    std::vector<int> globalPointers;    // offsets of globals the collector traces
+    bool errorStubUsed[NumRuntimeErrors];
+    std::map<std::string, const char*> stringLabels;
+    std::vector<std::pair<const char*, const char*> > stringPool;
+
+         // Returns the label of the pooled copy of string constant str,
+         // adding it to the pool the first time it is seen
+    const char *InternString(const char *str);
+
+         // Returns the label of the stub for the given error (which will
+         // then be generated), for a check to branch to when it fails
+    const char *RuntimeErrorLabel(RuntimeError err);
+
+         // Appends the stubs of the run-time errors that are used
+    void GenRuntimeErrorStubs();
+
+         // Reassigns the frame slots of one function's locals/temps so
+         // that variables with disjoint live intervals share a slot
+    void PackFrameSlots(std::vector<Instruction*> &fn, Liveness *liveness,
+                        Mips *mips);
+
+         // Decides how each arg pushed in fn is passed to its call
+    static void NumberArgs(std::vector<Instruction*> &fn);
+
+         // Generates the compares and jump tables of a switch dispatch
+         // on value over cases[lo, hi)
+    void GenCaseTree(Location *value, const std::vector<std::pair<int, const char*> > &cases,
+                     int lo, int hi, const char *defaultLabel);
+
+         // Turns the adds of a constant in fn into add-immediates
+    static void SelectImmediates(std::vector<Instruction*> &fn);
+
+         // Allocates a block of bytes, described by header, by bumping
+         // the runtime's heap pointer in line, calling _Alloc only when
+         // the current run of free memory is used up
+    Location *GenBumpAlloc(Location *header, int bytes);
+
+         // True if fn (BeginFunc through EndFunc) makes no calls
+    static bool IsLeafFunction(std::vector<Instruction*> &fn);
+
+         // Runs the machine-independent optimizations over the Tac of
+         // one function (BeginFunc through EndFunc, under the label
+         // fnLabel), rewriting fn
+    void OptimizeFunction(std::vector<Instruction*> &fn, const char *fnLabel);
+
+  public:
+           // Here are some class constants to remind you of the offsets
+           // used for globals, locals, and parameters. You will be
+           // responsible for using these when assigning Locations.
+           // In a MIPS stack frame, first local is at fp-8, subsequent locals
+           // are at fp-12, fp-16, and so on. The first param is at fp+4,
+           // subsequent ones as fp+8, fp+12, etc. (Because methods have secret
+           // "this" passed in first param slot at fp+4, all normal params
+           // are shifted up by 4.)  First global is at offset 0 from global
+           // pointer, all subsequent at +4, +8, etc.
+           // Conveniently, all vars are 4 bytes in size for code generation
+    static const int OffsetToFirstLocal = -8,
+                     OffsetToFirstParam = 4,
+                     OffsetToFirstGlobal = 0;
+    static const int VarSize = 4;
+
+    static Location* ThisPtr;
+    int LocalTempNum;
+
+    CodeGenerator();
+    
+         // Assigns a new unique label name and returns it. Does not
+         // generate any Tac instructions (see GenLabel below if needed)
+    char *NewLabel();
+
+    
+         // Creates and returns a Location for a new uniquely named
+         // temp variable. Does not generate any Tac instructions
+    Location *GenTempVar();
+    Location *GenLocalVar(const char* name);
+    Location *GenGlobalVar(const char *name, bool isPointer = false);
+         // Generates Tac instructions to load a constant value. Creates
+         // a new temp var to hold the result. The constant 
+         // value is passed as an integer, it can be 0 for integer zero,
+         // false for bool, NULL for null object, etc. All are just 4-byte
+         // zero in the code generation world.
+         // The second overloaded version is used for string constants,
+         // each distinct one is laid out once in the data segment.
+         // The LoadLabel method loads a label into a temporary.
+         // Each of the methods returns a Location for the temp var
+         // where the constant was loaded.
+    Location *GenLoadConstant(int value);
+    Location *GenLoadConstant(const char *str);
+    Location *GenLoadLabel(const char *label);
+
+
+         // Generates Tac instructions to copy value from one location to another
+    void GenAssign(Location *dst, Location *src);
+
+         // Generates Tac instructions to dereference addr and store value
+         // into that memory location. addr should hold a valid memory address
+         // (most likely computed from an array or field offset calculation).
+         // The optional offset argument can be used to offset the addr by a
+         // positive/negative number of bytes. If not given, 0 is assumed.
+    void GenStore(Location *addr, Location *val, int offset = 0);
+
+         // Generates Tac instructions to dereference addr and load contents
+         // from a memory location into a new temp var. addr should hold a
+         // valid memory address (most likely computed from an array or
+         // field offset calculation). Returns the Location for the new
+         // temporary variable where the result was stored. The optional
+         // offset argument can be used to offset the addr by a positive or
+         // negative number of bytes. If not given, 0 is assumed. Pass
+         // readOnly for a word that is never written again once the
+         // object is built (vtable pointers and entries, array lengths),
+         // which lets the optimizer move the load out of loops.
+    Location *GenLoad(Location *addr, int offset = 0, bool readOnly = false);
+
+    
+         // Generates Tac instructions to perform one of the binary ops
+         // identified by string name, such as "+" or "==".  Returns a
+         // Location object for the new temporary where the result
+         // was stored.
+    Location *GenBinaryOp(const char *opName, Location *op1, Location *op2);
+
+         // Generates var = var + delta in place, for ++ and --. Once
+         // instructions are selected this is a single add-immediate.
+    void GenIncrement(Location *var, int delta);
+
+    
+         // Generates the Tac instruction for pushing a single
+         // parameter. Used to set up for ACall and LCall instructions.
+         // The Decaf convention is that parameters are pushed right
+         // to left (so the first argument is pushed last)
+    void GenPushParam(Location *param);
+
+         // Generates the Tac instruction for popping parameters to
+         // clean up after an ACall or LCall instruction. All parameters
+         // are removed with one adjustment of the stack pointer.
+    void GenPopParams(int numBytesOfParams);
+
+         // Generates the Tac instructions for a LCall, a jump to
+         // a compile-time label. The params to the target routine
+         // should already have been pushed. If hasReturnValue is
+         // true,  a new temp var is created, the fn result is stored 
+         // there and that Location is returned. If false, no temp is
+         // created and NULL is returned
+    Location *GenLCall(const char *label, bool fnHasReturnValue);
+
+         // Generates the Tac instructions for ACall, a jump to an
+         // address computed at runtime. Works similarly to LCall,
+         // described above, in terms of return type.
+         // The fnAddr Location is expected to hold the address of
+         // the code to jump to (typically it was read from the vtable)
+    Location *GenACall(Location *fnAddr, bool fnHasReturnValue);
+
+         // Generates the Tac instructions to call one of
+         // the built-in functions (Read, Print, Alloc, etc.) Although
+         // you could just make a call to GenLCall above, this cover
+         // is a little more convenient to use.  The arguments to the
+         // builtin should be given as arg1 and arg2, NULL is used if 
+         // fewer than 2 args to pass. The method returns a Location
+         // for the new temp var holding the result.  For those
+         // built-ins with no return value (Print/Halt), no temporary
+         // is created and NULL is returned.
+    Location *GenBuiltInCall(BuiltIn b, Location *arg1 = NULL, Location *arg2 = NULL);
+
+         // True if label is that of one of the built-in functions. None
+         // of them writes to memory the program already has a pointer to.
+    static bool IsBuiltIn(const char *label);
+
+    
+         // These methods generate the Tac instructions for various
+         // control flow (branches, jumps, returns, labels)
+         // One minor detail to mention is that you can pass NULL
+         // (or omit arg) to GenReturn for a return that does not
+         // return a value
+    void GenIfZ(Location *test, const char *label);
+    void GenIfCmp(BinaryOp::OpCode rel, Location *op1, Location *op2,
+                  const char *label);
+    void GenGoto(const char *label);
+    void GenReturn(Location *val = NULL);
+    void GenLabel(const char *label);
+
+         // Generates the dispatch of a switch statement: a jump to the
+         // label paired with the value that value equals, or to
+         // defaultLabel if there is none. The cases must be sorted by
+         // value, without repeats.
+    void GenSwitch(Location *value, const std::vector<std::pair<int, const char*> > &cases,
+                   const char *defaultLabel);
+
+
+         // These methods generate the Tac instructions that mark the start
+         // and end of a function/method definition. 
+    BeginFunc *GenBeginFunc();
+    void GenEndFunc();
+
+    
+         // Generates the Tac instructions for defining vtable for a
+         // The methods parameter is expected to contain the vtable
+         // methods in the order they should be laid out.  The vtable
+         // is tagged with a label of the class name, so when you later
+         // need access to the vtable, you use LoadLabel of class name.
+         // The offsets of the fields holding pointers go in front of it.
+    void GenVTable(const char *className, List<const char*> *methodLabels,
+                   const std::vector<int> &pointerFields);
+
+
+         // Emits the final "object code" for the program by
+         // translating the sequence of Tac instructions into their mips
+         // equivalent and printing them out to stdout. If the debug
+         // flag tac is on (-d tac), it will not translate to MIPS,
+         // but instead just print the untranslated Tac. It may be
+         // useful in debugging to first make sure your Tac is correct.
+         // The pooled string constants are emitted after all the code.
+    void DoFinalCodeGen();
+
+    Location *GenNewArray(Location *numElems, bool pointerElems);
+    Location *GenArrayLen(Location *array);
+    Location* GenArrayAccess(Location* base, Location* subscript);
+
+    void GenMessage(const char *message);
+
+    Location *GenNew(const char *vTableLabel, int instanceSize);
+    Location *GenDynamicDispatch(Location *rcvr, int vtableOffset, List<Location*> *args, bool hasReturnValue);
+    Location *GenMethodCall(Location *rcvr, Location *meth, List<Location*> *args, bool fnHasReturnValue);
+    Location *GenStaticDispatch(Location *rcvr, const char *methodLabel, List<Location*> *args, bool hasReturnValue);
+
+};
+
+#endif
@@ -0,0 +1,134 @@
+/* File: copyprop.cc
+ * -----------------
+ * Implementation of the CopyPropagation class.
+ */
+
+#include "copyprop.h"
+#include "cfg.h"
+
+
+CopyPropagation::CopyPropagation(FlowGraph *g) : cfg(g), propagated(0)
+{
+  FindCopies();
+  Solve();
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *block = cfg->GetBlock(b);
+    if (!block->reachable) continue;
+    Copies avail = in[b];
+    for (int i = 0; i < block->code.size(); i++) {
+      Replace(block->code[i], avail);
+      Transfer(block->code[i], avail);
+    }
+  }
+}
+
+bool CopyPropagation::IsTracked(Location *var)
+{
+  return var && var->GetSegment() == fpRelative;
+}
+
+void CopyPropagation::FindCopies()
+{
+  Location *srcs[Instruction::MaxSources];
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    std::vector<Instruction*> &code = cfg->GetBlock(b)->code;
+    for (int i = 0; i < code.size(); i++) {
+      Assign *copy = dynamic_cast<Assign*>(code[i]);
+      if (!copy) continue;
+      copy->GetSources(srcs);
+      Location *dst = copy->GetDst();
+      if (!IsTracked(dst) || !IsTracked(srcs[0]) || dst == srcs[0])
+        continue;
+      copyIndex[copy] = copies.size();
+      copiesOf[dst].push_back(copies.size());
+      copiesOf[srcs[0]].push_back(copies.size());
+      copies.push_back(copy);
+    }
+  }
+}
+
+/* Method: Transfer
+ * ----------------
+ * Writing a variable ends every copy to or from it; a copy then starts
+ * a new one.
+ */
+void CopyPropagation::Transfer(Instruction *instr, Copies &avail)
+{
+  Location *dst = instr->GetDst();
+  if (!dst) return;
+  std::map<Location*, std::vector<int> >::iterator it = copiesOf.find(dst);
+  if (it != copiesOf.end())
+    for (int i = 0; i < it->second.size(); i++)
+      avail[it->second[i]] = false;
+  std::map<Assign*, int>::iterator c = copyIndex.find(dynamic_cast<Assign*>(instr));
+  if (c != copyIndex.end())
+    avail[c->second] = true;
+}
+
+/* Method: Solve
+ * -------------
+ * Iterates to the greatest fixed point: a block's in set starts out
+ * full (empty for the entry) and is cut down to the intersection of
+ * what its reachable predecessors let through.
+ */
+void CopyPropagation::Solve()
+{
+  const std::vector<BasicBlock*> &rpo = cfg->GetReversePostorder();
+  in.assign(cfg->NumBlocks(), Copies(copies.size(), true));
+  in[cfg->GetEntry()->id].assign(copies.size(), false);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 1; i < rpo.size(); i++) {
+      BasicBlock *b = rpo[i];
+      Copies meet(copies.size(), true);
+      for (int p = 0; p < b->preds.size(); p++) {
+        BasicBlock *pred = b->preds[p];
+        if (!pred->reachable) continue;
+        Copies out = in[pred->id];
+        for (int j = 0; j < pred->code.size(); j++)
+          Transfer(pred->code[j], out);
+        for (int c = 0; c < copies.size(); c++)
+          if (!out[c]) meet[c] = false;
+      }
+      if (meet != in[b->id]) {
+        in[b->id] = meet;
+        changed = true;
+      }
+    }
+  }
+}
+
+/* Method: Replace
+ * ---------------
+ * Rewrites each source of instr that is the destination of an
+ * available copy to the copy's source. The tracked copies themselves
+ * are left alone, as the sets above are in terms of their operands.
+ */
+void CopyPropagation::Replace(Instruction *instr, const Copies &avail)
+{
+  if (copyIndex.count(dynamic_cast<Assign*>(instr))) return;
+  Location *srcs[Instruction::MaxSources], *from[Instruction::MaxSources];
+  int n = instr->GetSources(srcs);
+  bool replaced = false;
+  for (int j = 0; j < n; j++) {
+    std::map<Location*, std::vector<int> >::iterator it = copiesOf.find(srcs[j]);
+    if (it == copiesOf.end()) continue;
+    for (int k = 0; k < it->second.size(); k++) {
+      Assign *copy = copies[it->second[k]];
+      if (!avail[it->second[k]] || copy->GetDst() != srcs[j]) continue;
+      copy->GetSources(from);
+      srcs[j] = from[0];
+      replaced = true;
+      propagated++;
+      break;
+    }
+  }
+  if (replaced) instr->SetSources(srcs);
+}
+
+void CopyPropagation::Rewrite(std::vector<Instruction*> &fn)
+{
+  cfg->Flatten(fn);
+  PrintDebug("copyprop", "%d uses propagated", propagated);
+}
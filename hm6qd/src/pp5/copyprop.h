@@ -0,0 +1,48 @@
+/* File: copyprop.h
+ * ----------------
+ * The CopyPropagation class replaces the uses of a variable that was
+ * copied from another ("x = y") by that other variable, wherever the
+ * copy reaches the use along every path and neither side has been
+ * written since. The copy itself is left for DeadCodeElimination to
+ * remove once nothing reads x any more.
+ *
+ * The copies available at each block entry are found by the usual
+ * forward data-flow problem (intersection at merges) over the
+ * FlowGraph. Only copies between fp-relative variables are tracked;
+ * a global may be changed by any call.
+ */
+
+#ifndef _H_copyprop
+#define _H_copyprop
+
+#include <map>
+#include <vector>
+#include "tac.h"
+class FlowGraph;
+class BasicBlock;
+
+class CopyPropagation {
+  private:
+    typedef std::vector<bool> Copies;   // indexed like copies
+
+    FlowGraph *cfg;
+    std::vector<Assign*> copies;
+    std::map<Location*, std::vector<int> > copiesOf;  // by either side
+    std::map<Assign*, int> copyIndex;
+    std::vector<Copies> in;             // per block, at block entry
+    int propagated;
+
+    static bool IsTracked(Location *var);
+    void FindCopies();
+    void Transfer(Instruction *instr, Copies &avail);
+    void Solve();
+    void Replace(Instruction *instr, const Copies &avail);
+
+  public:
+    CopyPropagation(FlowGraph *cfg);
+
+         // Writes the function's rewritten instructions to fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
@@ -0,0 +1,52 @@
+/* File: dce.cc
+ * ------------
+ * Implementation of the DeadCodeElimination class.
+ */
+
+#include "dce.h"
+#include "liveness.h"
+
+
+bool DeadCodeElimination::IsRemovable(Instruction *instr)
+{
+  Location *dst = instr->GetDst();
+  if (!dst || dst->GetSegment() != fpRelative) return false;
+  BinaryOp *op = dynamic_cast<BinaryOp*>(instr);
+  if (op)
+    return op->opcode() != BinaryOp::Div && op->opcode() != BinaryOp::Mod;
+  return dynamic_cast<Assign*>(instr) || dynamic_cast<LoadConstant*>(instr) ||
+         dynamic_cast<LoadLabel*>(instr) || dynamic_cast<LoadStringConstant*>(instr);
+}
+
+/* Method: Sweep
+ * -------------
+ * Makes one pass deleting the removable instructions whose destination
+ * is dead after them (or that copy a variable to itself). Returns
+ * whether anything was deleted.
+ */
+bool DeadCodeElimination::Sweep(std::vector<Instruction*> &fn)
+{
+  Liveness liveness(fn);
+  std::vector<Instruction*> live;
+  Location *srcs[Instruction::MaxSources];
+  for (int i = 0; i < fn.size(); i++) {
+    Instruction *instr = fn[i];
+    Location *dst = instr->GetDst();
+    bool selfCopy = dynamic_cast<Assign*>(instr) && instr->GetSources(srcs) &&
+                    srcs[0] == dst;
+    if (IsRemovable(instr) && (selfCopy || !liveness.IsLiveOut(i, dst)))
+      deleted++;
+    else
+      live.push_back(instr);
+  }
+  bool changed = live.size() != fn.size();
+  fn = live;
+  return changed;
+}
+
+void DeadCodeElimination::Rewrite(std::vector<Instruction*> &fn)
+{
+  while (Sweep(fn))
+    ;
+  PrintDebug("dce", "%d instructions deleted", deleted);
+}
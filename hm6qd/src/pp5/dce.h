@@ -0,0 +1,35 @@
+/* File: dce.h
+ * -----------
+ * The DeadCodeElimination class deletes the instructions of one
+ * function whose only effect is to write a variable that is not live
+ * afterwards: copies, constants, labels, strings and arithmetic.
+ * Division is kept, as it may trap, and so is anything that writes a
+ * global, which is not tracked by the Liveness analysis. Each deletion
+ * may leave the instructions feeding it dead in turn, so liveness is
+ * recomputed until there is nothing left to delete.
+ *
+ * A temp with no instructions left has no live interval, so when the
+ * frame is packed it no longer gets a slot.
+ */
+
+#ifndef _H_dce
+#define _H_dce
+
+#include <vector>
+#include "tac.h"
+
+class DeadCodeElimination {
+  private:
+    int deleted;
+
+    static bool IsRemovable(Instruction *instr);
+    bool Sweep(std::vector<Instruction*> &fn);
+
+  public:
+    DeadCodeElimination() : deleted(0) {}
+
+         // Deletes the dead instructions of fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
@@ -0,0 +1,574 @@
+_PrintInt:
+        subu $sp, $sp, 8
+        sw $fp, 8($sp)
+        sw $ra, 4($sp)
+        addiu $fp, $sp, 8
+        li   $v0, 1
+        lw   $a0, 4($fp)
+        syscall
+        move $sp, $fp
+        lw $ra, -4($fp)
+        lw $fp, 0($fp)
+        jr $ra
+                                
+_PrintString:
+        subu $sp, $sp, 8
+        sw $fp, 8($sp)
+        sw $ra, 4($sp)
+        addiu $fp, $sp, 8
+        li   $v0, 4
+        lw $a0, 4($fp)
+        syscall
+        move $sp, $fp
+        lw $ra, -4($fp)
+        lw $fp, 0($fp)
+        jr $ra
+        
+_PrintBool:
+	subu $sp, $sp, 8
+	sw $fp, 8($sp)
+	sw $ra, 4($sp)
+        addiu $fp, $sp, 8
+	lw $t1, 4($fp)
+	blez $t1, fbr
+	li   $v0, 4		# system call for print_str
+	la   $a0, TRUE		# address of str to print
+	syscall			
+	b end
+fbr:	li   $v0, 4		# system call for print_str
+	la   $a0, FALSE		# address of str to print
+	syscall				
+end:	move $sp, $fp
+	lw $ra, -4($fp)
+	lw $fp, 0($fp)
+	jr $ra
+
+# The heap is what sbrk has handed out (contiguously, as nothing else
+# calls it), from _HeapBase to _HeapTop, carved into blocks. Each block
+# is a header word followed by the object, array or string. The header
+# holds the size of what follows it, in bytes (a whole number of words),
+# with the kind of block in its low two bits (as HeapBlockKind in
+# codegen.h: 0 free, 1 no pointers, 2 array of pointers, 3 object) and
+# the collector's mark in its top bit. Memory not in use is kept zeroed,
+# so a zero word reads as a free block of no size.
+#
+# Objects are bumped out of the current run of free memory: _HeapNext
+# is where the next one goes (just past its header), _HeapEnd is the
+# end of the run plus 4. New sites test the same pair themselves and
+# call here only when the run is used up. The header is the one arg.
+_Alloc:
+	lw $a0, 4($sp)        # header (no frame: the fast path calls nothing)
+	la $t0, _HeapNext
+	lw $v0, 0($t0)
+	srl $t1, $a0, 2
+	sll $t1, $t1, 2       # bytes wanted
+	addu $t2, $v0, $t1
+	addiu $t2, $t2, 4     # where the one after goes
+	lw $t3, 4($t0)        # _HeapEnd
+	bltu $t3, $t2, _AllocSlow
+	sw $t2, 0($t0)
+	sw $a0, -4($v0)
+	jr $ra
+
+# The run is too small. Its rest goes on the free list, and another run
+# that fits is taken from it. If there is none, the heap is collected,
+# once it has reached _GCLimit, or else grown.
+_AllocSlow:
+	subu $sp, $sp, 8
+	sw $fp, 8($sp)
+	sw $ra, 4($sp)
+	addiu $fp, $sp, 8
+	subu $sp, $sp, 8
+	sw $a0, -8($fp)       # the header
+	sw $zero, -12($fp)    # whether the heap has been collected yet
+	jal _RetireRun
+_AllocFind:
+	lw $a0, -8($fp)
+	srl $a0, $a0, 2
+	sll $a0, $a0, 2
+	addiu $a0, $a0, 4     # size of the block
+	jal _FindRun
+	bnez $v0, _AllocTake
+	lw $t0, -12($fp)
+	bnez $t0, _AllocGrow
+	lw $t0, _HeapTop
+	lw $t1, _HeapBase
+	subu $t0, $t0, $t1
+	lw $t1, _GCLimit
+	blt $t0, $t1, _AllocGrow
+	jal _GCCollect
+	li $t0, 1
+	sw $t0, -12($fp)
+	b _AllocFind
+_AllocGrow:
+	lw $a0, -8($fp)
+	srl $a0, $a0, 2
+	sll $a0, $a0, 2
+	addiu $a0, $a0, 4
+	jal _GrowHeap
+_AllocTake:
+	lw $a0, -8($fp)
+	la $t0, _HeapNext
+	lw $v0, 0($t0)
+	srl $t1, $a0, 2
+	sll $t1, $t1, 2
+	addu $t2, $v0, $t1
+	addiu $t2, $t2, 4
+	sw $t2, 0($t0)
+	sw $a0, -4($v0)
+	move $sp, $fp
+	lw $ra, -4($fp)
+	lw $fp, 0($fp)
+	jr $ra
+
+# Puts what is left of the current run on the free list, as a free
+# block whose second word links to the next run. A single word is too
+# small to list and just stays zero.
+_RetireRun:
+	la $t0, _HeapNext
+	lw $t1, 0($t0)
+	lw $t2, 4($t0)
+	subu $t3, $t2, $t1    # bytes left
+	sw $zero, 0($t0)
+	sw $zero, 4($t0)
+	li $t4, 8
+	blt $t3, $t4, _RetireDone
+	addiu $t3, $t3, -4
+	sw $t3, -4($t1)       # header: FreeBlock
+	lw $t4, _FreeRuns
+	sw $t4, 0($t1)
+	addiu $t1, $t1, -4
+	sw $t1, _FreeRuns
+_RetireDone:
+	jr $ra
+
+# Makes the first free run of at least $a0 bytes the current run, with
+# its header and link zeroed again. $v0 is 0 if there is none.
+_FindRun:
+	la $t0, _FreeRuns     # the link to the run
+_FindRunNext:
+	lw $t1, 0($t0)
+	beqz $t1, _FindRunNone
+	lw $t2, 0($t1)
+	addiu $t2, $t2, 4     # size of the run
+	bgeu $t2, $a0, _FindRunTake
+	addiu $t0, $t1, 4
+	b _FindRunNext
+_FindRunTake:
+	lw $t3, 4($t1)
+	sw $t3, 0($t0)
+	sw $zero, 0($t1)
+	sw $zero, 4($t1)
+	addiu $t3, $t1, 4
+	sw $t3, _HeapNext
+	addu $t3, $t3, $t2
+	sw $t3, _HeapEnd
+	li $v0, 1
+	jr $ra
+_FindRunNone:
+	li $v0, 0
+	jr $ra
+
+# Gets a chunk of at least $a0 bytes from sbrk and makes it the current
+# run. A chunk is 64K unless the block needs more.
+_GrowHeap:
+	li $t1, 65536
+	bgeu $t1, $a0, _GrowSbrk
+	move $t1, $a0
+_GrowSbrk:
+	move $a0, $t1
+	li $v0, 9
+	syscall               # $v0 = the new chunk
+	lw $t2, _HeapBase
+	bnez $t2, _GrowSet
+	sw $v0, _HeapBase
+_GrowSet:
+	addu $t2, $v0, $t1
+	sw $t2, _HeapTop
+	addiu $t3, $v0, 4
+	sw $t3, _HeapNext
+	addiu $t2, $t2, 4
+	sw $t2, _HeapEnd
+	jr $ra
+
+# Mark-sweep collection. The blocks are laid out from their headers and
+# their pointers found from the kind: the pointer map in front of an
+# object's vtable (see Mips::EmitVTable), or every element of an array
+# of pointers. The globals that hold pointers are listed in
+# _GlobalPointers by the compiler.
+#
+# Registers and frames are scanned conservatively: the compiler keeps
+# values in registers and shares frame slots among variables, so no
+# word of the stack has one type for a whole function. Any word there
+# that points into or just past the start of a block keeps the block
+# alive, which covers the addresses of array elements held across a
+# call. Nothing moves, so a word that only looks like a pointer costs
+# memory, never correctness. Finding the block a word points into uses
+# a bitmap of block starts, built in memory just past the heap, which
+# then becomes free space.
+_GCCollect:
+	subu $sp, $sp, 8
+	sw $fp, 8($sp)
+	sw $ra, 4($sp)
+	addiu $fp, $sp, 8
+	subu $sp, $sp, 32     # the callers' $s registers, which are roots
+	sw $s0, -8($fp)
+	sw $s1, -12($fp)
+	sw $s2, -16($fp)
+	sw $s3, -20($fp)
+	sw $s4, -24($fp)
+	sw $s5, -28($fp)
+	sw $s6, -32($fp)
+	sw $s7, -36($fp)
+	lw $s0, _HeapBase
+	lw $s1, _HeapTop
+	subu $a0, $s1, $s0
+	srl $a0, $a0, 2
+	addiu $a0, $a0, 31
+	srl $a0, $a0, 5
+	sll $a0, $a0, 2       # a bit per word of heap
+	move $s3, $a0
+	li $v0, 9
+	syscall
+	move $s2, $v0         # the bitmap, at _HeapTop
+	sw $v0, _GCMap
+	move $t0, $s0
+_GCStarts:
+	bgeu $t0, $s1, _GCRoots
+	subu $t1, $t0, $s0
+	srl $t1, $t1, 2       # word number of the block
+	srl $t2, $t1, 5
+	sll $t2, $t2, 2
+	addu $t2, $t2, $s2
+	andi $t3, $t1, 31
+	li $t4, 1
+	sllv $t4, $t4, $t3
+	lw $t5, 0($t2)
+	or $t5, $t5, $t4
+	sw $t5, 0($t2)
+	lw $t1, 0($t0)
+	srl $t1, $t1, 2
+	sll $t1, $t1, 2
+	addu $t0, $t0, $t1
+	addiu $t0, $t0, 4
+	b _GCStarts
+
+_GCRoots:
+	move $s4, $sp         # the mark stack grows down from here
+	la $s5, _GlobalPointers
+	lw $s6, 0($s5)
+_GCGlobals:
+	beqz $s6, _GCStack
+	addiu $s5, $s5, 4
+	lw $t0, 0($s5)
+	addu $t0, $t0, $gp
+	lw $a0, 0($t0)
+	jal _GCMark
+	addiu $s6, $s6, -1
+	b _GCGlobals
+_GCStack:
+	move $s5, $fp         # follow the saved $fp out to main's frame
+_GCOuter:
+	lw $t0, 0($s5)
+	bgeu $s5, $t0, _GCScan
+	move $s5, $t0
+	b _GCOuter
+_GCScan:
+	addiu $s6, $s4, 4
+_GCScanNext:
+	bltu $s5, $s6, _GCDrain
+	lw $a0, 0($s6)
+	jal _GCMark
+	addiu $s6, $s6, 4
+	b _GCScanNext
+
+_GCDrain:
+	beq $sp, $s4, _GCSweep
+	addiu $sp, $sp, 4
+	lw $s5, 0($sp)        # a marked block, still to be traced
+	lw $t0, 0($s5)
+	andi $t0, $t0, 3
+	li $t1, 3             # ObjectBlock
+	beq $t0, $t1, _GCObject
+	li $t1, 2             # PointerArray
+	bne $t0, $t1, _GCDrain
+	lw $s6, 4($s5)        # length
+	addiu $s5, $s5, 8
+_GCElems:
+	blez $s6, _GCDrain
+	lw $a0, 0($s5)
+	jal _GCMark
+	addiu $s5, $s5, 4
+	addiu $s6, $s6, -1
+	b _GCElems
+_GCObject:
+	lw $s7, 4($s5)        # vtable
+	lw $s6, -4($s7)       # number of pointer fields, their offsets below
+_GCFields:
+	blez $s6, _GCDrain
+	addiu $s7, $s7, -4
+	lw $t0, -4($s7)
+	addu $t0, $t0, $s5
+	lw $a0, 4($t0)
+	jal _GCMark
+	addiu $s6, $s6, -1
+	b _GCFields
+
+# Unmarked blocks are zeroed and, with the free ones around them, make
+# up the new free runs, linked in address order.
+_GCSweep:
+	move $t0, $s2
+	addu $t1, $s2, $s3
+_GCClearMap:
+	bgeu $t0, $t1, _GCWalk
+	sw $zero, 0($t0)
+	addiu $t0, $t0, 4
+	b _GCClearMap
+_GCWalk:
+	move $s1, $t1
+	sw $s1, _HeapTop      # the bitmap is heap now
+	move $t0, $s0         # the block
+	li $t1, 0             # start of the free run it is in, if any
+	li $t2, 0             # bytes kept
+	la $t3, _FreeRuns     # the link for the next run
+	sw $zero, 0($t3)
+	li $t9, 0x7ffffffc
+_GCSweepNext:
+	bgeu $t0, $s1, _GCSweepEnd
+	lw $t4, 0($t0)
+	and $t5, $t4, $t9
+	addiu $t5, $t5, 4     # size of the block
+	bgez $t4, _GCFree
+	sll $t4, $t4, 1
+	srl $t4, $t4, 1
+	sw $t4, 0($t0)        # unmarked for next time
+	addu $t2, $t2, $t5
+	beqz $t1, _GCKeep
+	jal _GCCloseRun
+	li $t1, 0
+_GCKeep:
+	addu $t0, $t0, $t5
+	b _GCSweepNext
+_GCFree:
+	andi $t6, $t4, 3
+	beqz $t6, _GCFreeBlock
+	move $t6, $t0
+	addu $t7, $t0, $t5
+_GCZero:
+	sw $zero, 0($t6)
+	addiu $t6, $t6, 4
+	bltu $t6, $t7, _GCZero
+	b _GCJoin
+_GCFreeBlock:
+	beqz $t4, _GCJoin     # a word never used
+	sw $zero, 0($t0)      # the header and link of a run
+	sw $zero, 4($t0)
+_GCJoin:
+	bnez $t1, _GCFreeNext
+	move $t1, $t0
+_GCFreeNext:
+	addu $t0, $t0, $t5
+	b _GCSweepNext
+_GCSweepEnd:
+	beqz $t1, _GCLimitSet
+	jal _GCCloseRun
+_GCLimitSet:
+	sll $t2, $t2, 1       # collect again once the heap is twice what
+	li $t0, 262144        # is alive (but at least 256K)
+	bge $t2, $t0, _GCDone
+	move $t2, $t0
+_GCDone:
+	sw $t2, _GCLimit
+	lw $s0, -8($fp)
+	lw $s1, -12($fp)
+	lw $s2, -16($fp)
+	lw $s3, -20($fp)
+	lw $s4, -24($fp)
+	lw $s5, -28($fp)
+	lw $s6, -32($fp)
+	lw $s7, -36($fp)
+	move $sp, $fp
+	lw $ra, -4($fp)
+	lw $fp, 0($fp)
+	jr $ra
+
+# Lists the free run from $t1 to $t0 after the one $t3 links from. A
+# single word stays a zero.
+_GCCloseRun:
+	subu $t6, $t0, $t1
+	li $t7, 8
+	blt $t6, $t7, _GCCloseDone
+	addiu $t6, $t6, -4
+	sw $t6, 0($t1)
+	sw $t1, 0($t3)
+	addiu $t3, $t1, 4
+_GCCloseDone:
+	jr $ra
+
+# Marks the block $a0 points into (or just past the start of) and
+# pushes it onto the mark stack below $sp, unless $a0 is not in the
+# heap or the block is free or marked already. The block is the last
+# one starting at or before $a0 - 4 in the bitmap.
+_GCMark:
+	addiu $a0, $a0, -4
+	lw $t0, _HeapBase
+	bltu $a0, $t0, _GCMarkDone
+	lw $t1, _HeapTop
+	bgeu $a0, $t1, _GCMarkDone
+	subu $t1, $a0, $t0
+	srl $t1, $t1, 2
+	lw $t3, _GCMap
+	srl $t2, $t1, 5
+	sll $t2, $t2, 2
+	addu $t2, $t2, $t3
+	andi $t4, $t1, 31
+	li $t5, 31
+	subu $t5, $t5, $t4
+	li $t1, -1
+	srlv $t1, $t1, $t5    # the bits up to $a0's word
+	lw $t4, 0($t2)
+	and $t4, $t4, $t1
+_GCMarkBack:
+	bnez $t4, _GCMarkBit
+	addiu $t2, $t2, -4
+	lw $t4, 0($t2)
+	b _GCMarkBack
+_GCMarkBit:
+	li $t5, 31
+_GCMarkHigh:
+	bltz $t4, _GCMarkFound
+	sll $t4, $t4, 1
+	addiu $t5, $t5, -1
+	b _GCMarkHigh
+_GCMarkFound:
+	subu $t2, $t2, $t3
+	sll $t2, $t2, 5       # 128 bytes of heap per word of bitmap
+	sll $t5, $t5, 2
+	addu $t2, $t2, $t5
+	addu $t2, $t2, $t0    # the block
+	lw $t4, 0($t2)
+	bltz $t4, _GCMarkDone
+	andi $t5, $t4, 3
+	beqz $t5, _GCMarkDone
+	li $t5, 0x80000000
+	or $t4, $t4, $t5
+	sw $t4, 0($t2)
+	sw $t2, 0($sp)
+	subu $sp, $sp, 4
+_GCMarkDone:
+	jr $ra
+
+
+# Strings are word-aligned, with their length in the word before them
+# and zeros after the terminator up to the next word, so two strings of
+# the same length are equal if the words up to the one holding the
+# terminator are. Literals are pooled, so the same literal compares
+# equal without reading either.
+_StringEqual:
+	lw $t0, 4($sp)        # no frame: calls nothing
+	lw $t1, 8($sp)
+	li $v0, 1
+	beq $t0, $t1, _StrEqDone
+	li $v0, 0
+	beqz $t0, _StrEqDone
+	beqz $t1, _StrEqDone
+	lw $t2, -4($t0)
+	lw $t3, -4($t1)
+	bne $t2, $t3, _StrEqDone
+	addu $t2, $t0, $t2    # the terminator
+_StrEqLoop:
+	lw $t4, 0($t0)
+	lw $t5, 0($t1)
+	bne $t4, $t5, _StrEqDone
+	addiu $t0, $t0, 4
+	addiu $t1, $t1, 4
+	bgeu $t2, $t0, _StrEqLoop
+	li $v0, 1
+_StrEqDone:
+	jr $ra
+
+_Halt:
+        li $v0, 10
+        syscall
+
+_ReadInteger:
+	subu $sp, $sp, 8      # decrement sp to make space to save ra, fp
+	sw $fp, 8($sp)        # save fp
+	sw $ra, 4($sp)        # save ra
+	addiu $fp, $sp, 8     # set up new fp
+	subu $sp, $sp, 4      # decrement sp to make space for locals/temps
+	li $v0, 5
+	syscall
+	move $sp, $fp         # pop callee frame off stack
+	lw $ra, -4($fp)       # restore saved ra
+	lw $fp, 0($fp)        # restore saved fp
+	jr $ra
+        
+
+# Reads a line into SPACE, drops its newline and copies it into a new
+# string on the heap (a RawBlock: the length, then the characters,
+# padded with zeros to a whole word).
+_ReadLine:
+	subu $sp, $sp, 8      # decrement sp to make space to save ra, fp
+	sw $fp, 8($sp)        # save fp
+	sw $ra, 4($sp)        # save ra
+	addiu $fp, $sp, 8     # set up new fp
+	subu $sp, $sp, 4      # decrement sp to make space for locals/temps
+	li $a1, 40
+	la $a0, SPACE
+	li $v0, 8
+	syscall
+
+	la $t1, SPACE
+bloop4: 
+	lb $t5, ($t1) 
+	beqz $t5, eloop4	
+	addi $t1, 1
+	b bloop4
+eloop4:
+	addi $t1,-1
+	li $t6,0
+        sb $t6, ($t1)
+
+	la $t0, SPACE
+	subu $t1, $t1, $t0    # length
+	sw $t1, -8($fp)
+	addiu $t2, $t1, 4
+	srl $t2, $t2, 2
+	sll $t2, $t2, 2       # the characters and terminator, in words
+	addiu $t2, $t2, 5     # + length, RawBlock
+	subu $sp, $sp, 4
+	sw $t2, 4($sp)
+	jal _Alloc
+	addiu $sp, $sp, 4
+	lw $t1, -8($fp)
+	sw $t1, 0($v0)
+	addiu $v0, $v0, 4     # the string
+	la $t0, SPACE
+	move $t2, $v0
+bloop5:
+	lb $t5, ($t0)
+	beqz $t5, eloop5
+	sb $t5, ($t2)
+	addi $t0, 1
+	addi $t2, 1
+	b bloop5
+eloop5:
+	move $sp, $fp         # pop callee frame off stack
+	lw $ra, -4($fp)       # restore saved ra
+	lw $fp, 0($fp)        # restore saved fp
+	jr $ra
+	
+
+	.data
+	.align 2
+_HeapNext: .word 0            # where the next object goes
+_HeapEnd: .word 0             # end of the current run, plus 4
+_HeapBase: .word 0
+_HeapTop: .word 0
+_FreeRuns: .word 0            # free runs, linked through their second word
+_GCLimit: .word 262144        # heap size from which to collect, not grow
+_GCMap: .word 0               # the bitmap of block starts, while collecting
+TRUE:.asciiz "true"
+FALSE:.asciiz "false"
+SPACE:.asciiz "Making Space For Inputed Values Is Fun."
@@ -0,0 +1,190 @@
+/* File: inliner.cc
+ * ----------------
+ * Implementation of the Inliner class.
+ */
+
+#include "inliner.h"
+#include "codegen.h"
+#include <cstring>
+
+
+Inliner::Inliner(CodeGenerator *c, int optLevel)
+  : cg(c), budget(optLevel >= 3 ? 60 : optLevel >= 2 ? 20 : 0), inlined(0)
+{
+}
+
+/* Method: CountParams
+ * -------------------
+ * How many param slots the body refers to, up to the last it uses.
+ */
+int Inliner::CountParams(std::vector<Instruction*> &body)
+{
+  int count = 0;
+  Location *srcs[Instruction::MaxSources + 1];
+  for (int i = 0; i < body.size(); i++) {
+    int n = body[i]->GetSources(srcs);
+    if (body[i]->GetDst()) srcs[n++] = body[i]->GetDst();
+    for (int j = 0; j < n; j++) {
+      int slot = (srcs[j]->GetOffset() - CodeGenerator::OffsetToFirstParam) / CodeGenerator::VarSize;
+      if (srcs[j]->GetSegment() == fpRelative && slot >= count)
+        count = slot + 1;
+    }
+  }
+  return count;
+}
+
+/* Method: FindCallees
+ * -------------------
+ * Records the body (BeginFunc through EndFunc) of each function small
+ * enough to inline, under the label that starts it.
+ */
+void Inliner::FindCallees(std::vector<Instruction*> &code)
+{
+  for (int i = 0; i + 1 < code.size(); i++) {
+    Label *label = dynamic_cast<Label*>(code[i]);
+    if (!label || !dynamic_cast<BeginFunc*>(code[i+1]) || !strcmp(label->text(), "main"))
+      continue;
+    std::vector<Instruction*> body;
+    int size = 0;
+    bool recursive = false;
+    for (int j = i + 1; j < code.size(); j++) {
+      body.push_back(code[j]);
+      if (dynamic_cast<EndFunc*>(code[j])) break;
+      LCall *call = dynamic_cast<LCall*>(code[j]);
+      if (call && !strcmp(call->function_label(), label->text()))
+        recursive = true;
+      if (!dynamic_cast<Label*>(code[j]) && !dynamic_cast<BeginFunc*>(code[j]))
+        size++;
+    }
+    if (!recursive && size <= budget) {
+      bodies[label->text()] = body;
+      arity[label->text()] = CountParams(body);
+    }
+  }
+}
+
+/* Method: Remap
+ * -------------
+ * The caller's variable for a variable of the callee being inlined:
+ * the temp holding a param, a fresh temp for a local, the same global.
+ */
+Location *Inliner::Remap(Location *var)
+{
+  if (var->GetSegment() != fpRelative)
+    return var;
+  if (var->GetOffset() >= CodeGenerator::OffsetToFirstParam) {
+    Assert(params.count(var->GetOffset()));
+    return params[var->GetOffset()];
+  }
+  if (!vars.count(var)) vars[var] = cg->GenTempVar();
+  return vars[var];
+}
+
+/* Method: Expand
+ * --------------
+ * Replaces the call at the end of out, whose numParams PushParams are
+ * the last instructions there, by a copy of the callee's body. Returns
+ * false, changing nothing, if the callee is not to be inlined, or the
+ * params were not pushed right before the call, or not all the params
+ * the callee uses were pushed (a method called without its receiver).
+ */
+bool Inliner::Expand(std::vector<Instruction*> &out, LCall *call, int numParams,
+                     const char *caller)
+{
+  std::map<std::string, std::vector<Instruction*> >::iterator it =
+      bodies.find(call->function_label());
+  if (it == bodies.end() || !strcmp(caller, call->function_label()) ||
+      out.size() < numParams || arity[it->first] > numParams)
+    return false;
+  for (int i = 1; i <= numParams; i++)
+    if (!dynamic_cast<PushParam*>(out[out.size() - i])) return false;
+
+  // The param pushed last is the one at fp+4.
+  params.clear();
+  std::vector<Instruction*> copies;
+  Location *srcs[Instruction::MaxSources];
+  for (int i = 1; i <= numParams; i++) {
+    out[out.size() - i]->GetSources(srcs);
+    Location *param = cg->GenTempVar();
+    copies.push_back(new Assign(param, srcs[0]));
+    params[CodeGenerator::OffsetToFirstParam + (i - 1) * CodeGenerator::VarSize] = param;
+  }
+  out.resize(out.size() - numParams);
+  out.insert(out.end(), copies.begin(), copies.end());
+
+  std::vector<Instruction*> &body = it->second;
+  std::map<std::string, const char*> labels;
+  for (int i = 0; i < body.size(); i++)
+    if (Label *l = dynamic_cast<Label*>(body[i]))
+      labels[l->text()] = cg->NewLabel();
+  const char *end = cg->NewLabel();
+
+  vars.clear();
+  Location *result = call->GetDst();
+  for (int i = 0; i < body.size(); i++) {
+    Instruction *instr = body[i];
+    if (dynamic_cast<BeginFunc*>(instr) || dynamic_cast<EndFunc*>(instr))
+      continue;
+    int n = instr->GetSources(srcs);
+    for (int j = 0; j < n; j++)
+      srcs[j] = Remap(srcs[j]);
+    Location *dst = instr->GetDst();
+    if (dst) dst = Remap(dst);
+
+    if (Label *l = dynamic_cast<Label*>(instr))
+      instr = new Label(labels[l->text()]);
+    else if (Goto *g = dynamic_cast<Goto*>(instr))
+      instr = new Goto(labels.count(g->branch_label()) ? labels[g->branch_label()] : g->branch_label());
+    else if (CondBranch *cb = dynamic_cast<CondBranch*>(instr)) {
+      const char *target = labels.count(cb->branch_label()) ?
+                           labels[cb->branch_label()] : cb->branch_label();
+      IfCmp *cmp = dynamic_cast<IfCmp*>(instr);
+      instr = cmp ? (Instruction*)new IfCmp(cmp->opcode(), srcs[0], srcs[1], target)
+                  : (Instruction*)new IfZ(srcs[0], target);
+    } else if (JumpTable *jt = dynamic_cast<JumpTable*>(instr)) {
+      std::vector<const char*> targets = jt->branch_labels();
+      for (int j = 0; j < targets.size(); j++)
+        targets[j] = labels[targets[j]];
+      instr = new JumpTable(srcs[0], cg->NewLabel(), targets);
+    } else if (dynamic_cast<Return*>(instr)) {
+      if (n && result)
+        out.push_back(new Assign(result, srcs[0]));
+      if (dynamic_cast<EndFunc*>(body[i+1]))
+        continue;                       // falls into the end anyway
+      instr = new Goto(end);
+    } else {
+      instr = instr->Clone();
+      if (n) instr->SetSources(srcs);
+      if (dst) instr->SetDst(dst);
+    }
+    out.push_back(instr);
+  }
+  out.push_back(new Label(end));
+  PrintDebug("inline", "%s inlined into %s", call->function_label(), caller);
+  inlined++;
+  return true;
+}
+
+void Inliner::Rewrite(std::list<Instruction*> &code)
+{
+  if (!budget) return;
+  std::vector<Instruction*> in(code.begin(), code.end()), out;
+  FindCallees(in);
+  const char *caller = NULL;
+  for (int i = 0; i < in.size(); i++) {
+    Label *label = dynamic_cast<Label*>(in[i]);
+    if (label && i + 1 < in.size() && dynamic_cast<BeginFunc*>(in[i+1]))
+      caller = label->text();
+    LCall *call = dynamic_cast<LCall*>(in[i]);
+    if (call && caller) {
+      PopParams *pop = i + 1 < in.size() ? dynamic_cast<PopParams*>(in[i+1]) : NULL;
+      int numParams = pop ? pop->GetNumBytes() / CodeGenerator::VarSize : 0;
+      if (Expand(out, call, numParams, caller)) {
+        if (pop) i++;
+        continue;
+      }
+    }
+    out.push_back(in[i]);
+  }
+  code.assign(out.begin(), out.end());
+}
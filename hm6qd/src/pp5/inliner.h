@@ -0,0 +1,54 @@
+/* File: inliner.h
+ * ---------------
+ * The Inliner class replaces direct calls (LCall) to small functions
+ * and methods by a copy of the callee's body, so tiny accessors no
+ * longer pay for pushing their params, the call, the prologue and
+ * epilogue, and popping the params again. It runs over the Tac of the
+ * whole program before any function is optimized, so what it copies
+ * in is optimized along with the caller.
+ *
+ * In the copy, the callee's params (fp+4, fp+8, ...) become caller
+ * temps loaded from the values that were pushed, its locals and temps
+ * become fresh caller temps, its labels fresh labels, and each Return
+ * an assignment to the call's result and a jump to the end of the copy.
+ *
+ * A callee is inlined if its body has at most a budget of instructions
+ * (set by the optimization level) and it does not call itself. Only
+ * the original bodies are copied, so code inlined into a function is
+ * not inlined again; each callee is still emitted for other callers.
+ */
+
+#ifndef _H_inliner
+#define _H_inliner
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "tac.h"
+class CodeGenerator;
+
+class Inliner {
+  private:
+    CodeGenerator *cg;
+    int budget;
+    std::map<std::string, std::vector<Instruction*> > bodies;  // by label
+    std::map<std::string, int> arity;                         // by label
+    std::map<int, Location*> params;    // callee param offset -> caller temp
+    std::map<Location*, Location*> vars;  // callee local -> caller temp
+    int inlined;
+
+    static int CountParams(std::vector<Instruction*> &body);
+    void FindCallees(std::vector<Instruction*> &code);
+    Location *Remap(Location *var);
+    bool Expand(std::vector<Instruction*> &out, LCall *call, int numParams,
+                const char *caller);
+
+  public:
+    Inliner(CodeGenerator *cg, int optLevel);
+
+         // Rewrites code (the whole program) with the calls inlined
+    void Rewrite(std::list<Instruction*> &code);
+};
+
+#endif
@@ -0,0 +1,577 @@
+/* File: interp.cc
+ * ---------------
+ * Implementation of the TacInterpreter class.
+ */
+
+#include "interp.h"
+#include "codegen.h"
+#include "mips.h"
+#include "utility.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__)
+#define THREADED_DISPATCH 1
+#endif
+
+namespace {
+
+enum {
+  OpConst, OpMove, OpLoad, OpStore,
+  OpAdd, OpSub, OpMul, OpDiv, OpMod, OpEq, OpLess, OpAnd, OpOr,   // in the
+  OpNotEq, OpLessEq, OpGreater, OpGreaterEq, OpUGreaterEq,         // order of
+  OpUSub,                                                          // BinaryOp's
+  OpAddImm,
+  OpGoto, OpIfZ, OpIfEq, OpIfNotEq, OpIfLess, OpIfLessEq, OpIfGreater,
+  OpIfGreaterEq, OpIfUGreaterEq, OpJumpTable,
+  OpPush, OpPop, OpCall, OpACall, OpTailCall, OpReturn, OpReturnVoid,
+  OpAlloc, OpReadLine, OpReadInteger, OpStringEqual,     // in the order
+  OpPrintInt, OpPrintString, OpPrintBool, OpHalt,        // of BuiltIn
+  NumOpCodes
+};
+
+const char *builtinLabels[] = {"_Alloc", "_ReadLine", "_ReadInteger",
+  "_StringEqual", "_PrintInt", "_PrintString", "_PrintBool", "_Halt"};
+
+const int NoSlot = INT_MIN;
+const int DataBase = 0x1000;            // below it, null and what is near it
+const int TextBase = 0x70000000;        // method "addresses"
+const int MaxMemory = 0x40000000;
+const int StackSlots = 1 << 22;
+const int MaxArgs = 1 << 22;
+const int ChunkSize = 65536;
+
+}
+
+TacInterpreter::TacInterpreter(const std::vector<std::pair<const char*, const char*> > &stringPool,
+                               int globalBytes)
+  : strings(stringPool), numGlobals(globalBytes / CodeGenerator::VarSize),
+    heapNext(0), heapEnd(0), numSteps(0), numCalls(0)
+{
+}
+
+void TacInterpreter::AddFunction(const char *label, const std::vector<Instruction*> &fn)
+{
+  Function f;
+  f.label = label;
+  f.code = fn;
+  f.entry = -1;
+  f.numParams = f.frameSize = 0;
+  fnIndex[label] = fns.size();
+  fns.push_back(f);
+}
+
+void TacInterpreter::AddVTable(VTable *vtable)
+{
+  vtables.push_back(vtable);
+}
+
+/* Method: Slot
+ * ------------
+ * Where var lives while f runs: >= 0 is a slot of f's frame, params
+ * first, and < 0 the one's complement of an index into the globals.
+ */
+int TacInterpreter::Slot(Function &f, Location *var)
+{
+  if (var->GetSegment() == gpRelative)
+    return ~(var->GetOffset() / CodeGenerator::VarSize);
+  if (var->GetOffset() >= CodeGenerator::OffsetToFirstParam)
+    return (var->GetOffset() - CodeGenerator::OffsetToFirstParam) / CodeGenerator::VarSize;
+  std::map<Location*, int>::iterator it = f.slots.find(var);
+  if (it != f.slots.end())
+    return it->second;
+  int slot = f.numParams + f.slots.size();
+  f.slots[var] = slot;
+  f.frameSize = slot + 1;
+  return slot;
+}
+
+/* Method: Number
+ * --------------
+ * Counts f's params, the highest param slot any instruction uses, so
+ * that its other variables can be given the slots after them.
+ */
+void TacInterpreter::Number(Function &f)
+{
+  Location *vars[Instruction::MaxSources + 1];
+  for (int i = 0; i < f.code.size(); i++) {
+    int n = f.code[i]->GetSources(vars);
+    if (f.code[i]->GetDst()) vars[n++] = f.code[i]->GetDst();
+    for (int j = 0; j < n; j++)
+      if (vars[j]->GetSegment() == fpRelative &&
+          vars[j]->GetOffset() >= CodeGenerator::OffsetToFirstParam)
+        f.numParams = std::max(f.numParams, 1 + (vars[j]->GetOffset() -
+                                                 CodeGenerator::OffsetToFirstParam) / CodeGenerator::VarSize);
+  }
+  f.frameSize = f.numParams;
+}
+
+/* Method: LayOutData
+ * ------------------
+ * Lays out the data segment as the assembler would: the heap pointers
+ * the runtime and the fast path of new share, the string constants
+ * (each word-aligned after its length, as in Mips::EmitStringPool) and
+ * the vtables. The heap follows, from the first Alloc on.
+ */
+void TacInterpreter::LayOutData()
+{
+  mem.assign(DataBase, 0);
+  heapNext = mem.size();
+  heapEnd = heapNext + CodeGenerator::VarSize;
+  dataLabels["_HeapNext"] = heapNext;
+  dataLabels["_HeapEnd"] = heapEnd;
+  mem.resize(heapEnd + CodeGenerator::VarSize, 0);
+  for (int i = 0; i < strings.size(); i++) {
+    std::string text = Mips::StringValue(strings[i].second);
+    int len = text.size();
+    int addr = mem.size() + CodeGenerator::VarSize;
+    mem.resize(addr + (len + CodeGenerator::VarSize) / CodeGenerator::VarSize * CodeGenerator::VarSize, 0);
+    SetWord(addr - CodeGenerator::VarSize, len);
+    memcpy(&mem[addr], text.data(), len);
+    dataLabels[strings[i].first] = addr;
+  }
+  for (int i = 0; i < vtables.size(); i++) {
+    List<const char*> *methods = vtables[i]->method_labels();
+    int addr = mem.size();
+    mem.resize(addr + methods->NumElements() * CodeGenerator::VarSize, 0);
+    for (int m = 0; m < methods->NumElements(); m++) {
+      std::map<std::string, int>::iterator it = fnIndex.find(methods->Nth(m));
+      if (it != fnIndex.end())
+        SetWord(addr + m * CodeGenerator::VarSize, TextBase + it->second * CodeGenerator::VarSize);
+    }
+    dataLabels[vtables[i]->table_label()] = addr;
+  }
+}
+
+int TacInterpreter::AddOp(int code, int dst, int a, int b, int imm)
+{
+  Op op = {NULL, code, dst, a, b, imm};
+  ops.push_back(op);
+  return ops.size() - 1;
+}
+
+/* Method: Decode
+ * --------------
+ * Appends the Ops for f. Branches are left for Resolve, as they may
+ * jump forward (or, to a runtime error stub, into another function).
+ */
+void TacInterpreter::Decode(Function &f)
+{
+  Number(f);
+  Location *srcs[Instruction::MaxSources];
+  f.entry = ops.size();
+  labels[f.label] = f.entry;
+  for (int i = 0; i < f.code.size(); i++) {
+    Instruction *instr = f.code[i];
+    int n = instr->GetSources(srcs);
+    int a = n > 0 ? Slot(f, srcs[0]) : 0, b = n > 1 ? Slot(f, srcs[1]) : 0;
+    int dst = instr->GetDst() ? Slot(f, instr->GetDst()) : NoSlot;
+    if (Label *l = dynamic_cast<Label*>(instr)) {
+      labels[l->text()] = ops.size();
+    } else if (dynamic_cast<BeginFunc*>(instr)) {
+      continue;
+    } else if (dynamic_cast<EndFunc*>(instr)) {
+      AddOp(OpReturnVoid);
+    } else if (LoadConstant *lc = dynamic_cast<LoadConstant*>(instr)) {
+      AddOp(OpConst, dst, 0, 0, lc->value());
+    } else if (LoadStringConstant *ls = dynamic_cast<LoadStringConstant*>(instr)) {
+      AddOp(OpConst, dst, 0, 0, dataLabels[ls->pool_label()]);
+    } else if (LoadLabel *ll = dynamic_cast<LoadLabel*>(instr)) {
+      if (!dataLabels.count(ll->text()))
+        Failure("No data under label %s", ll->text());
+      AddOp(OpConst, dst, 0, 0, dataLabels[ll->text()]);
+    } else if (dynamic_cast<Assign*>(instr)) {
+      AddOp(OpMove, dst, a);
+    } else if (Load *ld = dynamic_cast<Load*>(instr)) {
+      AddOp(OpLoad, dst, a, 0, ld->GetOffset());
+    } else if (Store *st = dynamic_cast<Store*>(instr)) {
+      AddOp(OpStore, 0, a, b, st->GetOffset());
+    } else if (BinaryOp *bin = dynamic_cast<BinaryOp*>(instr)) {
+      AddOp(OpAdd + bin->opcode(), dst, a, b);
+    } else if (AddImm *ai = dynamic_cast<AddImm*>(instr)) {
+      AddOp(OpAddImm, dst, a, 0, ai->value());
+    } else if (Goto *g = dynamic_cast<Goto*>(instr)) {
+      fixups.push_back(std::make_pair(AddOp(OpGoto), g->branch_label()));
+    } else if (IfZ *z = dynamic_cast<IfZ*>(instr)) {
+      fixups.push_back(std::make_pair(AddOp(OpIfZ, 0, a), z->branch_label()));
+    } else if (IfCmp *c = dynamic_cast<IfCmp*>(instr)) {
+      int code = OpIfEq;
+      switch (c->opcode()) {
+        case BinaryOp::Eq: code = OpIfEq; break;
+        case BinaryOp::NotEq: code = OpIfNotEq; break;
+        case BinaryOp::Less: code = OpIfLess; break;
+        case BinaryOp::LessEq: code = OpIfLessEq; break;
+        case BinaryOp::Greater: code = OpIfGreater; break;
+        case BinaryOp::GreaterEq: code = OpIfGreaterEq; break;
+        case BinaryOp::UnsignedGreaterEq: code = OpIfUGreaterEq; break;
+        default: Failure("IfCmp on %s", BinaryOp::opName[c->opcode()]);
+      }
+      fixups.push_back(std::make_pair(AddOp(code, 0, a, b), c->branch_label()));
+    } else if (JumpTable *jt = dynamic_cast<JumpTable*>(instr)) {
+      int t = tables.size();
+      tables.push_back(std::vector<int>());
+      for (int k = 0; k < jt->branch_labels().size(); k++)
+        fixups.push_back(std::make_pair(-1 - t, jt->branch_labels()[k]));
+      AddOp(OpJumpTable, 0, a, 0, t);
+    } else if (TailCall *tc = dynamic_cast<TailCall*>(instr)) {
+      if (!fnIndex.count(tc->function_label()))
+        Failure("No function %s", tc->function_label());
+      for (int k = n - 1; k >= 0; k--)   // pushed as a call pushes them
+        AddOp(OpPush, 0, Slot(f, srcs[k]));
+      AddOp(OpTailCall, n, 0, 0, fnIndex[tc->function_label()]);
+    } else if (dynamic_cast<Return*>(instr)) {
+      AddOp(n ? OpReturn : OpReturnVoid, 0, a);
+    } else if (dynamic_cast<PushParam*>(instr)) {
+      AddOp(OpPush, 0, a);
+    } else if (PopParams *pp = dynamic_cast<PopParams*>(instr)) {
+      AddOp(OpPop, 0, 0, 0, pp->GetNumBytes() / CodeGenerator::VarSize);
+    } else if (LCall *call = dynamic_cast<LCall*>(instr)) {
+      int k = 0;
+      while (k < NumBuiltIns && strcmp(builtinLabels[k], call->function_label())) k++;
+      if (k < NumBuiltIns)
+        AddOp(OpAlloc + k, dst);
+      else if (fnIndex.count(call->function_label()))
+        AddOp(OpCall, dst, 0, 0, fnIndex[call->function_label()]);
+      else
+        Failure("No function %s", call->function_label());
+    } else if (dynamic_cast<ACall*>(instr)) {
+      AddOp(OpACall, dst, a);
+    } else
+      Failure("Can't interpret an instruction of %s", f.label);
+  }
+}
+
+/* Method: Resolve
+ * ---------------
+ * Points each branch, and each entry of a jump table (a fixup with
+ * the table number as a negative index), at the Op after its label.
+ */
+void TacInterpreter::Resolve()
+{
+  for (int i = 0; i < fixups.size(); i++) {
+    std::map<std::string, int>::iterator it = labels.find(fixups[i].second);
+    if (it == labels.end())
+      Failure("No label %s", fixups[i].second);
+    if (fixups[i].first >= 0)
+      ops[fixups[i].first].imm = it->second;
+    else
+      tables[-1 - fixups[i].first].push_back(it->second);
+  }
+}
+
+bool TacInterpreter::IsValid(int addr, int bytes)
+{
+  return addr >= DataBase && addr <= (int)mem.size() - bytes;
+}
+
+int TacInterpreter::Word(int addr)
+{
+  int w;
+  memcpy(&w, &mem[addr], sizeof(w));
+  return w;
+}
+
+void TacInterpreter::SetWord(int addr, int value)
+{
+  memcpy(&mem[addr], &value, sizeof(value));
+}
+
+/* Method: Alloc
+ * -------------
+ * _Alloc, for a block described by header (see HeapBlockKind): the
+ * same bump of _HeapNext against _HeapEnd, with a new chunk when the
+ * current one is used up. Returns 0 when memory runs out.
+ */
+int TacInterpreter::Alloc(int header)
+{
+  int bytes = header & ~3;
+  int next = Word(heapNext), end = Word(heapEnd);
+  if (next == 0 || bytes + CodeGenerator::VarSize > end - next) {
+    int chunk = std::max(ChunkSize, bytes + CodeGenerator::VarSize);
+    if (chunk > MaxMemory - (int)mem.size())
+      return 0;
+    next = mem.size() + CodeGenerator::VarSize;
+    end = next + chunk;
+    mem.resize(mem.size() + chunk, 0);
+  }
+  SetWord(next - CodeGenerator::VarSize, header);
+  SetWord(heapNext, next + bytes + CodeGenerator::VarSize);
+  SetWord(heapEnd, end);
+  return next;
+}
+
+/* Method: ReadLine
+ * ----------------
+ * _ReadLine: a line of the program's input, without its newline, as a new string on
+ * the heap. Returns 0 when memory runs out.
+ */
+int TacInterpreter::ReadLine()
+{
+  std::string line;
+  int ch;
+  while ((ch = getc(ProgramInput())) != EOF && ch != '\n')
+    line += ch;
+  int words = (line.size() + CodeGenerator::VarSize) / CodeGenerator::VarSize;
+  int s = Alloc((words + 1) * CodeGenerator::VarSize | RawBlock);
+  if (!s) return 0;
+  SetWord(s, line.size());
+  memcpy(&mem[s + CodeGenerator::VarSize], line.data(), line.size());
+  return s + CodeGenerator::VarSize;
+}
+
+/* Method: String
+ * --------------
+ * The characters of the string at s, or NULL if s is not a string the
+ * program could have made.
+ */
+const char *TacInterpreter::String(int s)
+{
+  if (!IsValid(s - CodeGenerator::VarSize, CodeGenerator::VarSize))
+    return NULL;
+  int len = Word(s - CodeGenerator::VarSize);
+  if (len < 0 || !IsValid(s, len + 1) || mem[s + len] != 0)
+    return NULL;
+  return (const char *)&mem[s];
+}
+
+bool TacInterpreter::StringEqual(int s1, int s2)
+{
+  if (s1 == s2) return true;
+  const char *t1 = String(s1), *t2 = String(s2);
+  return t1 && t2 && !strcmp(t1, t2);
+}
+
+/* Method: Execute
+ * ---------------
+ * With prepare set, only points each Op at its handler. Otherwise runs
+ * main. In the threaded version each handler ends by jumping to the
+ * handler of the Op it leaves ip at.
+ */
+void TacInterpreter::Execute(bool prepare)
+{
+#ifdef THREADED_DISPATCH
+#define CASE(c) L_##c
+#define DISPATCH goto *ip->handler
+  static const void *handlers[NumOpCodes] = {
+    &&L_OpConst, &&L_OpMove, &&L_OpLoad, &&L_OpStore,
+    &&L_OpAdd, &&L_OpSub, &&L_OpMul, &&L_OpDiv, &&L_OpMod, &&L_OpEq, &&L_OpLess,
+    &&L_OpAnd, &&L_OpOr, &&L_OpNotEq, &&L_OpLessEq, &&L_OpGreater, &&L_OpGreaterEq,
+    &&L_OpUGreaterEq, &&L_OpUSub, &&L_OpAddImm,
+    &&L_OpGoto, &&L_OpIfZ, &&L_OpIfEq, &&L_OpIfNotEq, &&L_OpIfLess, &&L_OpIfLessEq,
+    &&L_OpIfGreater, &&L_OpIfGreaterEq, &&L_OpIfUGreaterEq, &&L_OpJumpTable,
+    &&L_OpPush, &&L_OpPop, &&L_OpCall, &&L_OpACall, &&L_OpTailCall, &&L_OpReturn,
+    &&L_OpReturnVoid,
+    &&L_OpAlloc, &&L_OpReadLine, &&L_OpReadInteger, &&L_OpStringEqual,
+    &&L_OpPrintInt, &&L_OpPrintString, &&L_OpPrintBool, &&L_OpHalt};
+  if (prepare) {
+    for (int i = 0; i < ops.size(); i++)
+      ops[i].handler = handlers[ops[i].code];
+    return;
+  }
+#else
+#define CASE(c) case c
+#define DISPATCH goto dispatch
+  if (prepare) return;
+#endif
+#define SLOT(s) (*((s) >= 0 ? fp + (s) : globals + ~(s)))
+#define NEXT ip++; steps++; DISPATCH
+#define JUMP(cond) if (cond) ip = &ops[ip->imm]; else ip++; steps++; DISPATCH
+
+  std::vector<int> stack(StackSlots), globalArea(numGlobals + 1), args(MaxArgs);
+  std::vector<Frame> frames;
+  int *globals = &globalArea[0];
+  int numArgs = 0;
+  long long steps = 0;
+  const char *error = NULL;
+  const Function *f = &fns[fnIndex["main"]];
+  int *fp = &stack[0], *sp = fp + f->frameSize;
+  const Op *ip = &ops[f->entry];
+  int addr, val, dst;
+
+#ifdef THREADED_DISPATCH
+  DISPATCH;
+#else
+dispatch:
+  switch (ip->code) {
+#endif
+  CASE(OpConst): SLOT(ip->dst) = ip->imm; NEXT;
+  CASE(OpMove): SLOT(ip->dst) = SLOT(ip->a); NEXT;
+  CASE(OpLoad):
+    addr = SLOT(ip->a) + ip->imm;
+    if ((addr & 3) || !IsValid(addr, CodeGenerator::VarSize)) goto badAddress;
+    SLOT(ip->dst) = Word(addr);
+    NEXT;
+  CASE(OpStore):
+    addr = SLOT(ip->a) + ip->imm;
+    if ((addr & 3) || !IsValid(addr, CodeGenerator::VarSize)) goto badAddress;
+    SetWord(addr, SLOT(ip->b));
+    NEXT;
+  CASE(OpAdd): SLOT(ip->dst) = (unsigned)SLOT(ip->a) + (unsigned)SLOT(ip->b); NEXT;
+  CASE(OpSub): SLOT(ip->dst) = (unsigned)SLOT(ip->a) - (unsigned)SLOT(ip->b); NEXT;
+  CASE(OpMul): SLOT(ip->dst) = (unsigned)SLOT(ip->a) * (unsigned)SLOT(ip->b); NEXT;
+  CASE(OpDiv):
+    val = SLOT(ip->b);
+    if (val == 0) goto divideByZero;
+    SLOT(ip->dst) = val == -1 ? -(unsigned)SLOT(ip->a) : SLOT(ip->a) / val;
+    NEXT;
+  CASE(OpMod):
+    val = SLOT(ip->b);
+    if (val == 0) goto divideByZero;
+    SLOT(ip->dst) = val == -1 ? 0 : SLOT(ip->a) % val;
+    NEXT;
+  CASE(OpEq): SLOT(ip->dst) = SLOT(ip->a) == SLOT(ip->b); NEXT;
+  CASE(OpLess): SLOT(ip->dst) = SLOT(ip->a) < SLOT(ip->b); NEXT;
+  CASE(OpAnd): SLOT(ip->dst) = SLOT(ip->a) & SLOT(ip->b); NEXT;
+  CASE(OpOr): SLOT(ip->dst) = SLOT(ip->a) | SLOT(ip->b); NEXT;
+  CASE(OpNotEq): SLOT(ip->dst) = SLOT(ip->a) != SLOT(ip->b); NEXT;
+  CASE(OpLessEq): SLOT(ip->dst) = SLOT(ip->a) <= SLOT(ip->b); NEXT;
+  CASE(OpGreater): SLOT(ip->dst) = SLOT(ip->a) > SLOT(ip->b); NEXT;
+  CASE(OpGreaterEq): SLOT(ip->dst) = SLOT(ip->a) >= SLOT(ip->b); NEXT;
+  CASE(OpUGreaterEq): SLOT(ip->dst) = (unsigned)SLOT(ip->a) >= (unsigned)SLOT(ip->b); NEXT;
+  CASE(OpUSub): SLOT(ip->dst) = (unsigned)SLOT(ip->a) - (unsigned)SLOT(ip->b); NEXT;
+  CASE(OpAddImm): SLOT(ip->dst) = (unsigned)SLOT(ip->a) + ip->imm; NEXT;
+
+  CASE(OpGoto): ip = &ops[ip->imm]; steps++; DISPATCH;
+  CASE(OpIfZ): JUMP(SLOT(ip->a) == 0);
+  CASE(OpIfEq): JUMP(SLOT(ip->a) == SLOT(ip->b));
+  CASE(OpIfNotEq): JUMP(SLOT(ip->a) != SLOT(ip->b));
+  CASE(OpIfLess): JUMP(SLOT(ip->a) < SLOT(ip->b));
+  CASE(OpIfLessEq): JUMP(SLOT(ip->a) <= SLOT(ip->b));
+  CASE(OpIfGreater): JUMP(SLOT(ip->a) > SLOT(ip->b));
+  CASE(OpIfGreaterEq): JUMP(SLOT(ip->a) >= SLOT(ip->b));
+  CASE(OpIfUGreaterEq): JUMP((unsigned)SLOT(ip->a) >= (unsigned)SLOT(ip->b));
+  CASE(OpJumpTable):
+    val = SLOT(ip->a);
+    if (val < 0 || val >= tables[ip->imm].size()) goto badAddress;
+    ip = &ops[tables[ip->imm][val]];
+    steps++;
+    DISPATCH;
+
+  CASE(OpPush):
+    if (numArgs == MaxArgs) goto stackOverflow;
+    args[numArgs++] = SLOT(ip->a);
+    NEXT;
+  CASE(OpPop): numArgs -= ip->imm; NEXT;
+  CASE(OpACall):
+    val = SLOT(ip->a) - TextBase;
+    if (val < 0 || val % CodeGenerator::VarSize || val / CodeGenerator::VarSize >= fns.size())
+      goto badAddress;
+    f = &fns[val / CodeGenerator::VarSize];
+    goto call;
+  CASE(OpCall):
+    f = &fns[ip->imm];
+  call:
+    if (sp + f->frameSize > &stack[0] + stack.size()) goto stackOverflow;
+    {
+      Frame frame = {ip + 1, fp, sp, ip->dst};
+      frames.push_back(frame);
+    }
+    fp = sp;
+    for (int i = 0; i < f->numParams; i++)      // the last pushed is the first
+      fp[i] = i < numArgs ? args[numArgs - 1 - i] : 0;
+    sp = fp + f->frameSize;
+    std::fill(fp + f->numParams, sp, 0);
+    ip = &ops[f->entry];
+    numCalls++;
+    steps++;
+    DISPATCH;
+  CASE(OpTailCall):
+    f = &fns[ip->imm];
+    if (fp + f->frameSize > &stack[0] + stack.size()) goto stackOverflow;
+    for (int i = 0; i < f->numParams; i++)
+      fp[i] = i < ip->dst ? args[numArgs - 1 - i] : 0;
+    numArgs -= ip->dst;
+    sp = fp + f->frameSize;
+    std::fill(fp + f->numParams, sp, 0);
+    ip = &ops[f->entry];
+    numCalls++;
+    steps++;
+    DISPATCH;
+  CASE(OpReturn):
+    val = SLOT(ip->a);
+    goto leave;
+  CASE(OpReturnVoid):
+    val = 0;
+  leave:
+    steps++;
+    if (frames.empty()) goto halt;
+    fp = frames.back().fp;
+    sp = frames.back().sp;
+    ip = frames.back().ret;
+    dst = frames.back().dst;
+    frames.pop_back();
+    if (dst != NoSlot) SLOT(dst) = val;
+    DISPATCH;
+
+  CASE(OpAlloc):
+    val = Alloc(args[numArgs - 1]);
+    if (!val) goto outOfMemory;
+    SLOT(ip->dst) = val;
+    NEXT;
+  CASE(OpReadLine):
+    val = ReadLine();
+    if (!val) goto outOfMemory;
+    SLOT(ip->dst) = val;
+    NEXT;
+  CASE(OpReadInteger):
+    {
+      char line[64];
+      SLOT(ip->dst) = fgets(line, sizeof(line), ProgramInput()) ? atoi(line) : 0;
+    }
+    NEXT;
+  CASE(OpStringEqual):
+    SLOT(ip->dst) = StringEqual(args[numArgs - 1], args[numArgs - 2]);
+    NEXT;
+  CASE(OpPrintInt): printf("%d", args[numArgs - 1]); NEXT;
+  CASE(OpPrintString):
+    {
+      const char *s = String(args[numArgs - 1]);
+      if (!s) goto badAddress;
+      fputs(s, stdout);
+    }
+    NEXT;
+  CASE(OpPrintBool): fputs(args[numArgs - 1] > 0 ? "true" : "false", stdout); NEXT;
+  CASE(OpHalt): goto halt;
+#ifndef THREADED_DISPATCH
+  }
+#endif
+
+badAddress:
+  error = "bad address";
+  goto halt;
+divideByZero:
+  error = "division by zero";
+  goto halt;
+stackOverflow:
+  error = "stack overflow";
+  goto halt;
+outOfMemory:
+  error = "out of memory";
+halt:
+  fflush(stdout);
+  if (error)
+    printf("\n*** Runtime error: %s\n", error);
+  numSteps = steps;
+#undef CASE
+#undef DISPATCH
+#undef SLOT
+#undef NEXT
+#undef JUMP
+}
+
+void TacInterpreter::Run()
+{
+  if (!fnIndex.count("main"))
+    Failure("No main to run");
+  LayOutData();
+  for (int i = 0; i < fns.size(); i++)
+    Decode(fns[i]);
+  Resolve();
+  Execute(true);
+  Execute(false);
+  PrintDebug("runstats", "%lld Tac instructions, %d calls, %d bytes of memory",
+             numSteps, numCalls, (int)mem.size());
+}
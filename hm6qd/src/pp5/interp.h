@@ -0,0 +1,106 @@
+/* File: interp.h
+ * --------------
+ * The TacInterpreter class runs a whole program's Tac in process, for
+ * -d run, so a program can be tried (and timed) without SPIM.
+ *
+ * Before running, everything the Tac names is resolved. Each Label
+ * becomes the index of the instruction after it. Each Location becomes
+ * a slot: a param its own slot at the bottom of the frame, any other
+ * fp-relative variable the next slot after those, and a global its
+ * index in the global area. This does not use the Locations' offsets,
+ * which SSA versions share until frame slots are packed. The string
+ * pool, the vtables and the runtime's heap pointers are laid out in a
+ * byte-addressed memory, and string constants, vtables and labels
+ * become constant addresses. A method's address in a vtable is a
+ * made-up text address that selects the function.
+ *
+ * The instructions are then decoded into a flat array of Ops. Each Op
+ * holds the address of the code that runs it (GCC's labels as values),
+ * so each Op jumps straight to the next one's handler with no central
+ * switch (direct threading). Other compilers get a switch.
+ *
+ * The built-ins run natively. _Alloc bumps _HeapNext exactly as the
+ * runtime does, so the compiled fast path of new works unchanged.
+ * Memory is never collected; the heap just grows in 64K chunks. A
+ * runtime error stub is reached by a branch, so its temps use slots of
+ * the frame it was reached from, which is fine as it only halts. As
+ * dcc reads the program from stdin, ReadLine and ReadInteger read the
+ * file given with -i instead (without one, what is left of stdin,
+ * usually nothing). -d runstats reports what was run.
+ */
+
+#ifndef _H_interp
+#define _H_interp
+
+#include <map>
+#include <string>
+#include <vector>
+#include "tac.h"
+
+class TacInterpreter {
+  private:
+    struct Function {
+      const char *label;
+      std::vector<Instruction*> code;
+      int entry;                        // index of its first Op
+      int numParams, frameSize;         // in slots
+      std::map<Location*, int> slots;   // its locals and temps
+    };
+    struct Op {
+      const void *handler;              // where the code for code is
+      int code;
+      int dst, a, b;                    // slots
+      int imm;                          // constant, offset or target
+    };
+    struct Frame {
+      const Op *ret;
+      int *fp, *sp;
+      int dst;                          // in the caller's frame
+    };
+
+    std::vector<Function> fns;
+    std::map<std::string, int> fnIndex;
+    std::vector<VTable*> vtables;
+    std::vector<std::pair<const char*, const char*> > strings;
+    int numGlobals;
+
+    std::vector<Op> ops;
+    std::map<std::string, int> labels;  // -> index of Op
+    std::vector<std::pair<int, const char*> > fixups;
+    std::vector<std::vector<int> > tables;  // jump tables, as Op indices
+    std::map<std::string, int> dataLabels;  // -> address
+    std::vector<unsigned char> mem;
+    int heapNext, heapEnd;              // addresses of _HeapNext, _HeapEnd
+    long long numSteps;
+    int numCalls;
+
+    int Slot(Function &f, Location *var);
+    void Number(Function &f);
+    void LayOutData();
+    void Decode(Function &f);
+    void Resolve();
+    int AddOp(int code, int dst = 0, int a = 0, int b = 0, int imm = 0);
+
+    bool IsValid(int addr, int bytes);
+    int Word(int addr);
+    void SetWord(int addr, int value);
+    int Alloc(int header);
+    int ReadLine();
+    bool StringEqual(int s1, int s2);
+    const char *String(int s);
+
+    void Execute(bool prepare);
+
+  public:
+    TacInterpreter(const std::vector<std::pair<const char*, const char*> > &stringPool,
+                   int globalBytes);
+
+         // Adds a function, from BeginFunc through EndFunc, or a vtable
+    void AddFunction(const char *label, const std::vector<Instruction*> &fn);
+    void AddVTable(VTable *vtable);
+
+         // Runs main, with ProgramInput() and stdout as the program's
+    void Run();
+};
+
+#endif
@@ -0,0 +1,306 @@
+/* File: licm.cc
+ * -------------
+ * Implementation of the LoopInvariantCodeMotion class.
+ */
+
+#include "licm.h"
+#include "cfg.h"
+#include "sccp.h"
+#include "codegen.h"
+#include <cstring>
+
+
+LoopInvariantCodeMotion::LoopInvariantCodeMotion(FlowGraph *g, CodeGenerator *c)
+  : cfg(g), cg(c), hoisted(0)
+{
+  const std::vector<Loop*> &loops = cfg->GetLoops();
+  for (int i = 0; i < loops.size(); i++) {
+    FindInvariants(loops[i]);
+    if (!invariant.empty())
+      Hoist(loops[i]);
+  }
+}
+
+static bool IsPure(Instruction *instr)
+{
+  BinaryOp *op = dynamic_cast<BinaryOp*>(instr);
+  if (op)
+    return op->opcode() != BinaryOp::Div && op->opcode() != BinaryOp::Mod;
+  return dynamic_cast<LoadConstant*>(instr) || dynamic_cast<LoadLabel*>(instr) ||
+         dynamic_cast<LoadStringConstant*>(instr) || dynamic_cast<Assign*>(instr) ||
+         dynamic_cast<Label*>(instr);
+}
+
+/* Method: CountDefs
+ * -----------------
+ * Counts the definitions of each variable in the function and in the
+ * loop, and notes whether the loop may write to memory: a store, or a
+ * call to anything but a built-in.
+ */
+void LoopInvariantCodeMotion::CountDefs(Loop *loop)
+{
+  defs.clear();
+  defsInLoop.clear();
+  loopWrites = false;
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *block = cfg->GetBlock(b);
+    bool inLoop = loop->Contains(block);
+    for (int i = 0; i < block->code.size(); i++) {
+      Instruction *instr = block->code[i];
+      Location *dst = instr->GetDst();
+      if (dst) {
+        defs[dst]++;
+        if (inLoop) defsInLoop[dst]++;
+      }
+      LCall *lcall = dynamic_cast<LCall*>(instr);
+      if (inLoop && (dynamic_cast<Store*>(instr) || dynamic_cast<ACall*>(instr) ||
+                     (lcall && !CodeGenerator::IsBuiltIn(lcall->function_label()))))
+        loopWrites = true;
+    }
+  }
+}
+
+bool LoopInvariantCodeMotion::IsInvariant(Location *var)
+{
+  if (invariantVars.count(var)) return true;
+  if (defsInLoop[var]) return false;
+  return var->GetSegment() == fpRelative || !loopWrites;   // calls set globals
+}
+
+bool LoopInvariantCodeMotion::Dominates(BasicBlock *b, int pos, BasicBlock *useBlock, int usePos)
+{
+  return b == useBlock ? pos < usePos : cfg->Dominates(b, useBlock);
+}
+
+/* Method: CanMove
+ * ---------------
+ * Would the value instr (at pos in block) computes be the same if it
+ * were computed in the preheader instead? Its operands must not change
+ * in the loop, and it must be the only definition of its destination
+ * and dominate all the uses of it.
+ */
+bool LoopInvariantCodeMotion::CanMove(Instruction *instr, BasicBlock *block, int pos)
+{
+  Location *dst = instr->GetDst();
+  if (!dst || dst->GetSegment() != fpRelative || defs[dst] != 1)
+    return false;
+  Location *srcs[Instruction::MaxSources];
+  int n = instr->GetSources(srcs);
+  for (int i = 0; i < n; i++)
+    if (!IsInvariant(srcs[i])) return false;
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *use = cfg->GetBlock(b);
+    for (int i = 0; i < use->code.size(); i++) {
+      n = use->code[i]->GetSources(srcs);
+      for (int j = 0; j < n; j++)
+        if (srcs[j] == dst && !Dominates(block, pos, use, i))
+          return false;
+    }
+  }
+  return true;
+}
+
+bool LoopInvariantCodeMotion::IsMovableLoad(Instruction *instr)
+{
+  Load *load = dynamic_cast<Load*>(instr);
+  return load && (load->IsReadOnly() || !loopWrites);
+}
+
+/* Method: EntryValue
+ * ------------------
+ * Finds the constant var holds when control first falls into the loop
+ * header, looking back through the straight-line blocks before it.
+ */
+bool LoopInvariantCodeMotion::EntryValue(Loop *loop, Location *var, int *val)
+{
+  BasicBlock *header = loop->header;
+  if (header->id == 0) return false;
+  BasicBlock *b = cfg->GetBlock(header->id - 1);
+  if (loop->Contains(b) || b->succs.size() != 1) return false;
+  for (int steps = 0; b && steps < 8; steps++) {
+    for (int i = b->code.size() - 1; i >= 0; i--) {
+      if (b->code[i]->GetDst() != var) continue;
+      LoadConstant *lc = dynamic_cast<LoadConstant*>(b->code[i]);
+      if (lc) *val = lc->value();
+      return lc != NULL;
+    }
+    b = b->preds.size() == 1 ? b->preds[0] : NULL;
+  }
+  return false;
+}
+
+/* Method: EntersBody
+ * ------------------
+ * True if the test that ends the header is known to stay in the loop
+ * the first time round, in which case body is set to the block it
+ * then goes to (provided that block can only be reached from there).
+ */
+bool LoopInvariantCodeMotion::EntersBody(Loop *loop, BasicBlock **body)
+{
+  BasicBlock *h = loop->header;
+  CondBranch *test = dynamic_cast<CondBranch*>(h->GetLast());
+  if (!test || h->succs.size() != 2) return false;
+
+  Location *srcs[Instruction::MaxSources];
+  int n = test->GetSources(srcs), vals[Instruction::MaxSources];
+  for (int i = 0; i < n; i++) {
+    bool known = false, defined = false;
+    for (int j = 0; j + 1 < h->code.size(); j++) {
+      if (h->code[j]->GetDst() != srcs[i]) continue;
+      LoadConstant *lc = dynamic_cast<LoadConstant*>(h->code[j]);
+      defined = true;
+      known = lc != NULL;
+      if (lc) vals[i] = lc->value();
+    }
+    if (!defined) known = EntryValue(loop, srcs[i], &vals[i]);
+    if (!known) return false;
+  }
+  int jumps;
+  IfCmp *cmp = dynamic_cast<IfCmp*>(test);
+  if (cmp) {
+    if (!ConstantPropagation::Fold(cmp->opcode(), vals[0], vals[1], &jumps))
+      return false;
+  } else
+    jumps = vals[0] == 0;                 // IfZ
+
+  BasicBlock *target = NULL, *next = NULL;
+  for (int i = 0; i < h->succs.size(); i++) {
+    const char *label = h->succs[i]->GetLabel();
+    if (label && !strcmp(label, test->branch_label()))
+      target = h->succs[i];
+    else
+      next = h->succs[i];
+  }
+  *body = jumps ? target : next;
+  return *body && loop->Contains(*body) && (*body)->preds.size() == 1;
+}
+
+/* Method: FindSafePrefix
+ * ----------------------
+ * Walks the code every entry into the loop runs before it can do
+ * anything observable, marking the movable instructions, loads
+ * included, as invariant. It stops at the first instruction that has a
+ * side effect or may fault and is not being moved.
+ */
+void LoopInvariantCodeMotion::FindSafePrefix(Loop *loop)
+{
+  BasicBlock *b = loop->header, *body;
+  bool entersBody = EntersBody(loop, &body);
+  while (b) {
+    int end = b->code.size();
+    if (b == loop->header && dynamic_cast<CondBranch*>(b->GetLast()))
+      end--;                              // the loop test
+    for (int i = 0; i < end; i++) {
+      Instruction *instr = b->code[i];
+      if ((IsPure(instr) || IsMovableLoad(instr)) && CanMove(instr, b, i)) {
+        invariant.insert(instr);
+        invariantVars.insert(instr->GetDst());
+      } else if (!IsPure(instr))
+        return;
+    }
+    b = (b == loop->header && entersBody) ? body : NULL;
+  }
+}
+
+void LoopInvariantCodeMotion::FindInvariants(Loop *loop)
+{
+  invariant.clear();
+  invariantVars.clear();
+  CountDefs(loop);
+  FindSafePrefix(loop);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int b = 0; b < cfg->NumBlocks(); b++) {
+      BasicBlock *block = cfg->GetBlock(b);
+      if (!loop->Contains(block)) continue;
+      for (int i = 0; i < block->code.size(); i++) {
+        Instruction *instr = block->code[i];
+        if (invariant.count(instr) || dynamic_cast<Label*>(instr) ||
+            !IsPure(instr) || !CanMove(instr, block, i))
+          continue;
+        invariant.insert(instr);
+        invariantVars.insert(instr->GetDst());
+        changed = true;
+      }
+    }
+  }
+  KeepCheapConstants(loop);
+}
+
+static bool IsConstant(Instruction *instr)
+{
+  return dynamic_cast<LoadConstant*>(instr) || dynamic_cast<LoadLabel*>(instr) ||
+         dynamic_cast<LoadStringConstant*>(instr);
+}
+
+/* Method: KeepCheapConstants
+ * --------------------------
+ * Loading a constant takes one instruction, so holding it in a register
+ * across the loop is only worth it if nothing left in the loop uses it
+ * (it then feeds just the code moved out). Otherwise it stays, and
+ * whatever was to move with it on account of it stays as well.
+ */
+void LoopInvariantCodeMotion::KeepCheapConstants(Loop *loop)
+{
+  std::map<Location*, Instruction*> defOf;
+  for (std::set<Instruction*>::iterator it = invariant.begin(); it != invariant.end(); ++it)
+    defOf[(*it)->GetDst()] = *it;
+  Location *srcs[Instruction::MaxSources];
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int b = 0; b < cfg->NumBlocks(); b++) {
+      BasicBlock *block = cfg->GetBlock(b);
+      if (!loop->Contains(block)) continue;
+      for (int i = 0; i < block->code.size(); i++) {
+        Instruction *instr = block->code[i];
+        bool moves = invariant.count(instr) > 0;
+        int n = instr->GetSources(srcs);
+        for (int j = 0; j < n; j++) {
+          Instruction *def = invariantVars.count(srcs[j]) ? defOf[srcs[j]] : NULL;
+          Instruction *stays = NULL;
+          if (def && !moves && IsConstant(def))
+            stays = def;
+          else if (!def && moves && defsInLoop[srcs[j]])
+            stays = instr;
+          if (stays && invariant.erase(stays)) {
+            invariantVars.erase(stays->GetDst());
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+}
+
+/* Method: Hoist
+ * -------------
+ * Moves the invariant instructions to the end of the preheader. Taking
+ * them in reverse postorder keeps each definition ahead of its uses.
+ */
+void LoopInvariantCodeMotion::Hoist(Loop *loop)
+{
+  BasicBlock *pre = cfg->InsertPreheader(loop, cg->NewLabel());
+  if (!pre) return;
+  const std::vector<BasicBlock*> &rpo = cfg->GetReversePostorder();
+  for (int b = 0; b < rpo.size(); b++) {
+    BasicBlock *block = rpo[b];
+    if (!loop->Contains(block)) continue;
+    std::vector<Instruction*> rest;
+    for (int i = 0; i < block->code.size(); i++) {
+      if (invariant.count(block->code[i])) {
+        pre->code.push_back(block->code[i]);
+        hoisted++;
+      } else
+        rest.push_back(block->code[i]);
+    }
+    block->code = rest;
+  }
+}
+
+void LoopInvariantCodeMotion::Rewrite(std::vector<Instruction*> &fn)
+{
+  cfg->Flatten(fn);
+  PrintDebug("licm", "%d instructions hoisted", hoisted);
+}
@@ -0,0 +1,66 @@
+/* File: licm.h
+ * ------------
+ * The LoopInvariantCodeMotion class moves the instructions of a loop
+ * that compute the same value on every iteration into the loop's
+ * preheader, so that they run once per entry into the loop. Loops are
+ * handled innermost first, so something invariant in a whole nest ends
+ * up in front of the outermost loop it does not depend on.
+ *
+ * An instruction is invariant if its operands are defined outside the
+ * loop or by other invariant instructions. It is only moved if it is
+ * the sole definition of its destination in the function and comes
+ * before every use of it, which is how the code generator's temps are
+ * written, so the value seen by each use is unchanged.
+ *
+ * Constants, labels, copies and arithmetic cannot fail, so they are
+ * moved from anywhere in the loop (division, which may trap, is not).
+ * A load is moved only if what it reads cannot change in the loop:
+ * either it is marked read-only (vtables, array lengths) or the loop
+ * has no stores and no calls other than to built-ins. As a load may
+ * also fault, it must moreover be one the loop was sure to do before
+ * anything observable: in the header, or at the start of the body when
+ * the loop test is known to pass on entry.
+ */
+
+#ifndef _H_licm
+#define _H_licm
+
+#include <map>
+#include <set>
+#include <vector>
+#include "tac.h"
+class FlowGraph;
+class BasicBlock;
+class Loop;
+class CodeGenerator;
+
+class LoopInvariantCodeMotion {
+  private:
+    FlowGraph *cfg;
+    CodeGenerator *cg;
+    std::map<Location*, int> defs, defsInLoop;
+    std::set<Instruction*> invariant;
+    std::set<Location*> invariantVars;
+    bool loopWrites;                    // stores or calls that may
+    int hoisted;
+
+    void CountDefs(Loop *loop);
+    bool IsInvariant(Location *var);
+    bool CanMove(Instruction *instr, BasicBlock *block, int pos);
+    bool Dominates(BasicBlock *b, int pos, BasicBlock *useBlock, int usePos);
+    bool IsMovableLoad(Instruction *instr);
+    bool EntryValue(Loop *loop, Location *var, int *val);
+    bool EntersBody(Loop *loop, BasicBlock **body);
+    void FindSafePrefix(Loop *loop);
+    void FindInvariants(Loop *loop);
+    void KeepCheapConstants(Loop *loop);
+    void Hoist(Loop *loop);
+
+  public:
+    LoopInvariantCodeMotion(FlowGraph *cfg, CodeGenerator *cg);
+
+         // Writes the function's rewritten instructions to fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
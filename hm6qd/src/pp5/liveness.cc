@@ -0,0 +1,172 @@
+/* File: liveness.cc
+ * -----------------
+ * Implementation of the Liveness class.
+ */
+
+#include "liveness.h"
+#include <algorithm>
+#include <string>
+
+
+Liveness::Liveness(std::vector<Instruction*> &fnCode) : code(fnCode)
+{
+  NumberVariables();
+  Solve();
+  BuildIntervals();
+}
+
+Liveness::~Liveness()
+{
+  for (int i = 0; i < intervals.size(); i++)
+    delete intervals[i];
+}
+
+bool Liveness::IsTracked(Location *var)
+{
+  return var && var->GetSegment() == fpRelative;
+}
+
+/* Method: NumberVariables
+ * -----------------------
+ * Assigns each tracked variable mentioned in the function a dense index
+ * used for the bit vectors of the data-flow sets.
+ */
+void Liveness::NumberVariables()
+{
+  Location *srcs[Instruction::MaxSources];
+  for (int i = 0; i < code.size(); i++) {
+    Location *dst = code[i]->GetDst();
+    if (IsTracked(dst) && !varIndex.count(dst)) {
+      varIndex[dst] = vars.size();
+      vars.push_back(dst);
+    }
+    int n = code[i]->GetSources(srcs);
+    for (int j = 0; j < n; j++)
+      if (IsTracked(srcs[j]) && !varIndex.count(srcs[j])) {
+        varIndex[srcs[j]] = vars.size();
+        vars.push_back(srcs[j]);
+      }
+  }
+}
+
+/* Method: ComputeSuccessors
+ * -------------------------
+ * Control falls through to the next instruction except after a Goto,
+ * jump table, Return or EndFunc. Goto, IfZ and IfCmp also transfer to
+ * their target label, unless it is a run-time error stub outside the
+ * function, and a jump table to each of its labels.
+ */
+void Liveness::ComputeSuccessors(std::vector<std::vector<int> > &succ)
+{
+  std::map<std::string, int> labels;
+  for (int i = 0; i < code.size(); i++) {
+    Label *l = dynamic_cast<Label*>(code[i]);
+    if (l) labels[l->text()] = i;
+  }
+  succ.resize(code.size());
+  for (int i = 0; i < code.size(); i++) {
+    Instruction *instr = code[i];
+    Goto *g = dynamic_cast<Goto*>(instr);
+    CondBranch *cb = dynamic_cast<CondBranch*>(instr);
+    if (g) {
+      if (labels.count(g->branch_label()))
+        succ[i].push_back(labels[g->branch_label()]);
+      continue;
+    }
+    if (cb && labels.count(cb->branch_label()))
+      succ[i].push_back(labels[cb->branch_label()]);
+    JumpTable *jt = dynamic_cast<JumpTable*>(instr);
+    for (int j = 0; jt && j < jt->branch_labels().size(); j++)
+      succ[i].push_back(labels[jt->branch_labels()[j]]);
+    if (jt || dynamic_cast<Return*>(instr) || dynamic_cast<EndFunc*>(instr))
+      continue;
+    if (i + 1 < code.size())
+      succ[i].push_back(i + 1);
+  }
+}
+
+/* Method: Solve
+ * -------------
+ * Iterates in' = use + (out - def), out = union of in' over successors
+ * until nothing changes. Visiting the instructions last to first makes
+ * straight-line code converge in a single pass; loops take a few more.
+ */
+void Liveness::Solve()
+{
+  std::vector<std::vector<int> > succ;
+  ComputeSuccessors(succ);
+  int n = code.size();
+  liveIn.assign(n, std::vector<bool>(vars.size(), false));
+  liveOut.assign(n, std::vector<bool>(vars.size(), false));
+
+  Location *srcs[Instruction::MaxSources];
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = n - 1; i >= 0; i--) {
+      std::vector<bool> out(vars.size(), false);
+      for (int s = 0; s < succ[i].size(); s++) {
+        std::vector<bool> &in = liveIn[succ[i][s]];
+        for (int v = 0; v < vars.size(); v++)
+          if (in[v]) out[v] = true;
+      }
+      std::vector<bool> in = out;
+      Location *dst = code[i]->GetDst();
+      if (IsTracked(dst)) in[varIndex[dst]] = false;
+      int numSrcs = code[i]->GetSources(srcs);
+      for (int j = 0; j < numSrcs; j++)
+        if (IsTracked(srcs[j])) in[varIndex[srcs[j]]] = true;
+      if (in != liveIn[i] || out != liveOut[i]) {
+        liveIn[i] = in;
+        liveOut[i] = out;
+        changed = true;
+      }
+    }
+  }
+}
+
+static bool StartsBefore(LiveInterval *a, LiveInterval *b)
+{
+  return a->start < b->start || (a->start == b->start && a->end < b->end);
+}
+
+/* Method: BuildIntervals
+ * ----------------------
+ * A variable's interval runs from the first to the last instruction at
+ * which it is live on entry or written. It crosses a call if there is a
+ * call strictly inside the interval: the value must then survive the
+ * callee, which clobbers the caller-saved registers.
+ */
+void Liveness::BuildIntervals()
+{
+  std::vector<LiveInterval*> byVar(vars.size(), (LiveInterval*)NULL);
+  std::vector<int> callsBefore(code.size() + 1, 0);
+  for (int i = 0; i < code.size(); i++) {
+    callsBefore[i+1] = callsBefore[i] + (code[i]->IsCall() ? 1 : 0);
+    Location *dst = code[i]->GetDst();
+    for (int v = 0; v < vars.size(); v++) {
+      if (!liveIn[i][v] && !(IsTracked(dst) && varIndex[dst] == v))
+        continue;
+      if (!byVar[v])
+        byVar[v] = new LiveInterval(vars[v], i);
+      byVar[v]->end = i;
+    }
+  }
+  for (int v = 0; v < vars.size(); v++) {
+    LiveInterval *li = byVar[v];
+    if (!li) continue;
+    li->crossesCall = callsBefore[li->end] - callsBefore[li->start + 1] > 0;
+    intervals.push_back(li);
+  }
+  std::sort(intervals.begin(), intervals.end(), StartsBefore);
+}
+
+bool Liveness::IsLiveIn(int pos, Location *var)
+{
+  return IsTracked(var) && varIndex.count(var) && liveIn[pos][varIndex[var]];
+}
+
+bool Liveness::IsLiveOut(int pos, Location *var)
+{
+  return IsTracked(var) && varIndex.count(var) && liveOut[pos][varIndex[var]];
+}
@@ -0,0 +1,60 @@
+/* File: liveness.h
+ * ----------------
+ * The Liveness class runs live variable analysis over the Tac
+ * instructions of one function (BeginFunc through EndFunc) and
+ * summarizes the result as a live interval per variable.
+ *
+ * Only fp-relative variables (params, locals and temps) are tracked.
+ * Globals live in memory that any call can read or write, so they are
+ * never candidates for a register and are left out of the analysis.
+ *
+ * The analysis is the usual backwards data-flow problem solved to a
+ * fixed point over the instruction-level flow graph implied by Label,
+ * Goto and IfZ. An interval is the span [start, end] of instruction
+ * indices at which the variable is live or written; it is conservative
+ * (it covers any holes in the live range), which is exactly what the
+ * linear-scan allocator in Mips expects.
+ */
+
+#ifndef _H_liveness
+#define _H_liveness
+
+#include <map>
+#include <vector>
+#include "tac.h"
+
+class LiveInterval {
+  public:
+    Location *var;
+    int start, end;
+    bool crossesCall;  // is the variable live across some LCall/ACall?
+
+    LiveInterval(Location *v, int s) : var(v), start(s), end(s), crossesCall(false) {}
+};
+
+class Liveness {
+  private:
+    std::vector<Instruction*> &code;
+    std::map<Location*, int> varIndex;
+    std::vector<Location*> vars;
+    std::vector<std::vector<bool> > liveIn, liveOut;
+    std::vector<LiveInterval*> intervals;
+
+    bool IsTracked(Location *var);
+    void NumberVariables();
+    void ComputeSuccessors(std::vector<std::vector<int> > &succ);
+    void Solve();
+    void BuildIntervals();
+
+  public:
+    Liveness(std::vector<Instruction*> &fnCode);
+    ~Liveness();
+
+    bool IsLiveIn(int pos, Location *var);
+    bool IsLiveOut(int pos, Location *var);
+
+         // Intervals sorted by increasing start point
+    const std::vector<LiveInterval*> &GetIntervals() { return intervals; }
+};
+
+#endif
@@ -0,0 +1,159 @@
+/* File: lvn.cc
+ * ------------
+ * Implementation of the ValueNumbering class.
+ */
+
+#include "lvn.h"
+#include "cfg.h"
+
+
+ValueNumbering::ValueNumbering(FlowGraph *g) : cfg(g), nextNum(0), replaced(0)
+{
+  for (int b = 0; b < cfg->NumBlocks(); b++)
+    Number(cfg->GetBlock(b));
+}
+
+int ValueNumbering::NumberOf(Location *var)
+{
+  std::map<Location*, int>::iterator it = varNum.find(var);
+  if (it != varNum.end()) return it->second;
+  SetNumber(var, nextNum++);
+  return varNum[var];
+}
+
+void ValueNumbering::SetNumber(Location *var, int num)
+{
+  std::map<Location*, int>::iterator it = varNum.find(var);
+  if (it != varNum.end()) {
+    std::vector<Location*> &h = holders[it->second];
+    for (int i = 0; i < h.size(); i++)
+      if (h[i] == var) h.erase(h.begin() + i--);
+  }
+  varNum[var] = num;
+  holders[num].push_back(var);
+}
+
+static bool IsCommutative(BinaryOp::OpCode code)
+{
+  return code == BinaryOp::Add || code == BinaryOp::Mul || code == BinaryOp::Eq ||
+         code == BinaryOp::NotEq || code == BinaryOp::And || code == BinaryOp::Or;
+}
+
+/* Method: Key
+ * -----------
+ * Describes the value instr computes in terms of the value numbers of
+ * its operands, so that two instructions with the same key compute the
+ * same value. isLoad is set for a load of a word that might change.
+ * Returns false for the instructions that are not numbered this way.
+ */
+bool ValueNumbering::Key(Instruction *instr, std::string &key, bool *isLoad)
+{
+  char buf[160];
+  Location *srcs[Instruction::MaxSources];
+  *isLoad = false;
+  if (LoadConstant *lc = dynamic_cast<LoadConstant*>(instr))
+    sprintf(buf, "c %d", lc->value());
+  else if (LoadLabel *ll = dynamic_cast<LoadLabel*>(instr))
+    sprintf(buf, "l %.150s", ll->text());
+  else if (BinaryOp *op = dynamic_cast<BinaryOp*>(instr)) {
+    op->GetSources(srcs);
+    int a = NumberOf(srcs[0]), b = NumberOf(srcs[1]);
+    if (IsCommutative(op->opcode()) && b < a) std::swap(a, b);
+    sprintf(buf, "b %d %d %d", op->opcode(), a, b);
+  } else if (Load *load = dynamic_cast<Load*>(instr)) {
+    load->GetSources(srcs);
+    *isLoad = !load->IsReadOnly();
+    sprintf(buf, "m %d %d", NumberOf(srcs[0]), load->GetOffset());
+  } else
+    return false;
+  key = buf;
+  return true;
+}
+
+/* Method: ForgetMemory
+ * --------------------
+ * After a store, what a load reads may have changed. After a call, the
+ * globals may have changed as well: they lose their numbers, so they
+ * get fresh ones when next read. Constants and labels are forgotten
+ * at a call too, as loading one again costs less than keeping it in a
+ * register the call preserves.
+ */
+void ValueNumbering::ForgetMemory(bool globalsToo)
+{
+  loads.clear();
+  if (!globalsToo) return;
+  std::map<std::string, int>::iterator e = exprs.begin();
+  while (e != exprs.end()) {
+    if (e->first[0] == 'c' || e->first[0] == 'l')
+      exprs.erase(e++);                 // cheaper to reload than to save
+    else
+      ++e;
+  }
+  std::map<Location*, int>::iterator it = varNum.begin();
+  while (it != varNum.end()) {
+    if (it->first->GetSegment() != gpRelative) {
+      ++it;
+      continue;
+    }
+    std::vector<Location*> &h = holders[it->second];
+    for (int i = 0; i < h.size(); i++)
+      if (h[i] == it->first) h.erase(h.begin() + i--);
+    varNum.erase(it++);
+  }
+}
+
+/* Method: Number
+ * --------------
+ * Walks the block in order, replacing each instruction whose key has
+ * been seen before by a copy from a variable still holding that value,
+ * or dropping it if its destination already does.
+ */
+void ValueNumbering::Number(BasicBlock *block)
+{
+  varNum.clear();
+  holders.clear();
+  exprs.clear();
+  loads.clear();
+  std::vector<Instruction*> code;
+  for (int i = 0; i < block->code.size(); i++) {
+    Instruction *instr = block->code[i];
+    Location *dst = instr->GetDst();
+    std::string key;
+    bool isLoad;
+    if (dst && Key(instr, key, &isLoad)) {
+      std::map<std::string, int> &table = isLoad ? loads : exprs;
+      std::map<std::string, int>::iterator it = table.find(key);
+      if (it == table.end()) {
+        table[key] = nextNum;
+        SetNumber(dst, nextNum++);
+      } else {
+        std::vector<Location*> &h = holders[it->second];
+        Location *holder = NULL;
+        for (int j = 0; j < h.size(); j++)
+          if (!holder || holder->GetSegment() != fpRelative) holder = h[j];
+        if (holder) {
+          replaced++;
+          if (holder == dst) continue;
+          instr = new Assign(dst, holder);
+        }
+        SetNumber(dst, it->second);
+      }
+    } else {
+      if (dynamic_cast<Store*>(instr) || instr->IsCall())
+        ForgetMemory(instr->IsCall());
+      Location *srcs[Instruction::MaxSources];
+      if (dynamic_cast<Assign*>(instr) && instr->GetSources(srcs))
+        SetNumber(dst, NumberOf(srcs[0]));
+      else if (dst)
+        SetNumber(dst, nextNum++);
+    }
+    code.push_back(instr);
+  }
+  block->code = code;
+}
+
+void ValueNumbering::Rewrite(std::vector<Instruction*> &fn)
+{
+  cfg->Flatten(fn);
+  PrintDebug("lvn", "%d redundant computations replaced", replaced);
+}
@@ -0,0 +1,51 @@
+/* File: lvn.h
+ * -----------
+ * The ValueNumbering class removes recomputations of a value within a
+ * basic block (local value numbering). Every fresh value gets a
+ * number, and each constant, label, BinaryOp and Load is keyed by its
+ * opcode and the numbers of its operands, so
+ *
+ *     _tmp4 = *(_tmp1 + -4)      _tmp4 = *(_tmp1 + -4)
+ *     ...                  =>    ...
+ *     _tmp9 = *(_tmp1 + -4)      _tmp9 = _tmp4
+ *
+ * whenever some variable still holds the earlier result. The copy is
+ * left for SSAForm to coalesce away.
+ *
+ * A Store might write any word not known to be read-only, so it makes
+ * the other loads unknown again; a call does that too, and also to the
+ * globals, which it may assign.
+ */
+
+#ifndef _H_lvn
+#define _H_lvn
+
+#include <map>
+#include <string>
+#include <vector>
+#include "tac.h"
+class FlowGraph;
+class BasicBlock;
+
+class ValueNumbering {
+  private:
+    FlowGraph *cfg;
+    std::map<Location*, int> varNum;
+    std::map<int, std::vector<Location*> > holders;  // vars with the value
+    std::map<std::string, int> exprs, loads;
+    int nextNum, replaced;
+
+    int NumberOf(Location *var);
+    void SetNumber(Location *var, int num);
+    bool Key(Instruction *instr, std::string &key, bool *isLoad);
+    void ForgetMemory(bool globalsToo);
+    void Number(BasicBlock *block);
+
+  public:
+    ValueNumbering(FlowGraph *cfg);
+
+         // Writes the function's rewritten instructions to fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
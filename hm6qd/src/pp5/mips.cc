@@ -0,0 +1,817 @@
+/* File: mips.cc
+ * -------------
+ * Implementation of Mips class, which is responsible for TAC->MIPS
+ * translation, register allocation, etc.
+ *
+ * Julie Zelenski academic year 2001-02 for CS143
+ * Loosely based on some earlier work by Steve Freund
+ *
+ * A simple final code generator to translate Tac to MIPS.
+ * It uses simplistic algorithms, in particular, its register handling
+ * and spilling strategy is inefficient to the point of begin mocked
+ * by elementary school children.
+ *
+ * Dan Bentley, April 2002
+ * A simpler final code generator to translate Tac to MIPS.
+ * It uses algorithms without loops or conditionals, to make there be a
+ * very clear and obvious translation between one and the other.
+ * Specifically, it always loads operands off stacks, and stores the
+ * result back.  This breaks bad code immediately, theoretically helping
+ * students.
+ */
+
+#include "mips.h"
+#include "liveness.h"
+#include <stdarg.h>
+#include <cstring>
+#include <algorithm>
+
+
+
+// Helper to check if two variable locations are one and the same
+// (same name, segment, and offset)
+static bool LocationsAreSame(Location *var1, Location *var2)
+{
+   return (var1 == var2 ||
+	     (var1 && var2
+		&& !strcmp(var1->GetName(), var2->GetName())
+		&& var1->GetSegment()  == var2->GetSegment()
+		&& var1->GetOffset() == var2->GetOffset()));
+}
+
+
+/* Method: SpillRegister
+ * ---------------------
+ * Used to spill a register from reg to dst.  All it does is emit a store
+ * from that register to its location on the stack.
+ */
+void Mips::SpillRegister(Location *dst, Register reg)
+{
+  Assert(dst);
+  const char *offsetFromWhere = dst->GetSegment() == fpRelative? regs[fp].name : regs[gp].name;
+  Assert(dst->GetOffset() % 4 == 0); // all variables are 4 bytes in size
+  Emit("sw %s, %d(%s)\t# spill %s from %s to %s%+d", regs[reg].name,
+       dst->GetOffset(), offsetFromWhere, dst->GetName(), regs[reg].name,
+       offsetFromWhere,dst->GetOffset());
+}
+
+/* Method: FillRegister
+ * --------------------
+ * Fill a register from location src into reg.
+ * Simply load a word into a register.
+ */
+void Mips::FillRegister(Location *src, Register reg)
+{
+  Assert(src);
+  const char *offsetFromWhere = src->GetSegment() == fpRelative? regs[fp].name : regs[gp].name;
+  Assert(src->GetOffset() % 4 == 0); // all variables are 4 bytes in size
+  Emit("lw %s, %d(%s)\t# fill %s to %s from %s%+d", regs[reg].name,
+       src->GetOffset(), offsetFromWhere, src->GetName(), regs[reg].name,
+       offsetFromWhere,src->GetOffset());
+}
+
+
+/* Method: GetRegister
+ * --------------------
+ * Returns the register holding var. A variable the allocator assigned a
+ * register simply lives there. Any other variable is slaved to the
+ * given scratch register: filled from memory if it is about to be read,
+ * left alone if the caller is about to write it (see WriteBack).
+ */
+Mips::Register Mips::GetRegister(Location *var, Reason reason, Register scratch)
+{
+  std::map<Location*, Register>::iterator it = varRegs.find(var);
+  if (it != varRegs.end())
+    return it->second;
+  if (reason == ForRead)
+    FillRegister(var, scratch);
+  return scratch;
+}
+
+/* Method: WriteBack
+ * -----------------
+ * Commits a freshly computed value in reg to dst. Nothing to do if reg
+ * is dst's own register, otherwise the value is moved into dst's
+ * register or spilled to its stack slot.
+ */
+void Mips::WriteBack(Location *dst, Register reg)
+{
+  Register r = GetRegister(dst, ForWrite, reg);
+  if (r != reg)
+    Emit("move %s, %s\t\t# copy into %s", regs[r].name, regs[reg].name,
+	 dst->GetName());
+  else if (!varRegs.count(dst))
+    SpillRegister(dst, reg);
+}
+
+bool Mips::IsCalleeSaved(Register reg)
+{
+  return reg >= s0 && reg <= s7;
+}
+
+/* Method: AllocateRegisters
+ * -------------------------
+ * Linear-scan register allocation (Poletto & Sarkar) over the live
+ * intervals of the function about to be emitted. Intervals are visited
+ * in order of increasing start; those that ended are expired from the
+ * active set and their registers returned to the pool. An interval that
+ * crosses a call must get a callee-saved $s register, since the runtime
+ * routines in defs.asm clobber the $t registers; other intervals prefer
+ * the caller-saved $t3-$t9 ($t0-$t2 remain the scratch registers).
+ * When no suitable register is free, whichever of the current interval
+ * and the active interval ending last gets to stay in memory.
+ */
+void Mips::AllocateRegisters(const std::vector<LiveInterval*> &intervals)
+{
+  varRegs.clear();
+  savedRegs.clear();
+  params.clear();
+  for (int i = 0; i < intervals.size(); i++)
+    if (intervals[i]->var->GetSegment() == fpRelative &&
+	intervals[i]->var->GetOffset() > 0)
+      params.push_back(intervals[i]->var);
+  std::vector<LiveInterval*> active;
+  bool inUse[NumRegs] = {false};
+
+  for (int i = 0; i < intervals.size(); i++) {
+    LiveInterval *cur = intervals[i];
+    for (int j = active.size() - 1; j >= 0; j--)
+      if (active[j]->end < cur->start) {
+	inUse[varRegs[active[j]->var]] = false;
+	active.erase(active.begin() + j);
+      }
+
+    Register found = zero;
+    if (!cur->crossesCall)
+      for (int j = 0; j < NumCallerSaved && found == zero; j++)
+	if (!inUse[callerSaved[j]]) found = callerSaved[j];
+    for (int j = 0; j < NumCalleeSaved && found == zero; j++)
+      if (!inUse[calleeSaved[j]]) found = calleeSaved[j];
+
+    if (found == zero) {
+      int victim = -1;
+      for (int j = 0; j < active.size(); j++) {
+	if (cur->crossesCall && !IsCalleeSaved(varRegs[active[j]->var]))
+	  continue;
+	if (victim == -1 || active[j]->end > active[victim]->end)
+	  victim = j;
+      }
+      if (victim == -1 || active[victim]->end <= cur->end)
+	continue;                 // cur stays in memory
+      found = varRegs[active[victim]->var];
+      varRegs.erase(active[victim]->var);
+      active.erase(active.begin() + victim);
+    }
+    varRegs[cur->var] = found;
+    inUse[found] = true;
+    active.push_back(cur);
+  }
+
+  std::map<Location*, Register>::iterator it;
+  for (it = varRegs.begin(); it != varRegs.end(); ++it) {
+    if (IsCalleeSaved(it->second) &&
+	std::find(savedRegs.begin(), savedRegs.end(), it->second) == savedRegs.end())
+      savedRegs.push_back(it->second);
+    PrintDebug("regalloc", "%s -> %s", it->first->GetName(), regs[it->second].name);
+  }
+  std::sort(savedRegs.begin(), savedRegs.end());
+}
+
+
+/* Method: Emit
+ * ------------
+ * General purpose helper used to emit assembly instructions in
+ * a reasonable tidy manner.  Takes printf-style formatting strings
+ * and variable arguments.
+ */
+void Mips::Emit(const char *fmt, ...)
+{
+  va_list args;
+  char buf[1024];
+  
+  va_start(args, fmt);
+  vsprintf(buf, fmt, args);
+  va_end(args);
+  if (buf[strlen(buf) - 1] != ':') printf("\t"); // don't tab in labels
+  if (buf[0] != '#') printf("  ");   // outdent comments a little
+  printf("%s", buf);
+  if (buf[strlen(buf)-1] != '\n') printf("\n"); // end with a newline
+}
+
+
+
+/* Method: EmitLoadConstant
+ * ------------------------
+ * Used to assign variable an integer constant value.  Slaves dst into
+ * a register (using GetRegister above) and then emits an li (load
+ * immediate) instruction with the constant value.
+ */
+void Mips::EmitLoadConstant(Location *dst, int val)
+{
+  Register r = GetRegister(dst, ForWrite, rd);
+  Emit("li %s, %d\t\t# load constant value %d into %s", regs[r].name,
+	 val, val, regs[r].name);
+  WriteBack(dst, r);
+}
+
+/* Method: EmitLoadStringConstant
+ * ------------------------------
+ * Used to assign a variable a pointer to string constant. The string
+ * itself is laid out under label by EmitStringPool (length first), so
+ * all that is left here is to load that label address into dst.
+ */
+void Mips::EmitLoadStringConstant(Location *dst, const char *label)
+{
+  EmitLoadLabel(dst, label);
+}
+
+
+/* Method: EmitLoadLabel
+ * ---------------------
+ * Used to load a label (ie address in text/data segment) into a variable.
+ * Slaves dst into a register and emits an la (load address) instruction
+ */
+void Mips::EmitLoadLabel(Location *dst, const char *label)
+{
+  Register r = GetRegister(dst, ForWrite, rd);
+  Emit("la %s, %s\t# load label", regs[r].name, label);
+  WriteBack(dst, r);
+}
+ 
+
+/* Method: EmitCopy
+ * ----------------
+ * Used to copy the value of one variable to another.  Slaves both
+ * src and dst into registers and then emits a move instruction to
+ * copy the contents from src to dst.
+ */
+void Mips::EmitCopy(Location *dst, Location *src)
+{
+  if (varRegs.count(dst)) {
+    Register r = varRegs[dst];
+    if (varRegs.count(src)) {
+      if (varRegs[src] != r)
+	Emit("move %s, %s\t\t# copy %s", regs[r].name,
+	     regs[varRegs[src]].name, src->GetName());
+    } else
+      FillRegister(src, r);
+  } else
+    SpillRegister(dst, GetRegister(src, ForRead, rd));
+}
+
+
+/* Method: EmitLoad
+ * ----------------
+ * Used to assign dst the contents of memory at the address in reference,
+ * potentially with some positive/negative offset (defaults to 0).
+ * Slaves both ref and dst to registers, then emits a lw instruction
+ * using constant-offset addressing mode y(rx) which accesses the address
+ * at an offset of y bytes from the address currently contained in rx.
+ */
+void Mips::EmitLoad(Location *dst, Location *reference, int offset)
+{
+  Register base = GetRegister(reference, ForRead, rs);
+  Register r = GetRegister(dst, ForWrite, rd);
+  Emit("lw %s, %d(%s) \t# load with offset", regs[r].name,
+	 offset, regs[base].name);
+  WriteBack(dst, r);
+}
+
+
+/* Method: EmitStore
+ * -----------------
+ * Used to write value to  memory at the address in reference,
+ * potentially with some positive/negative offset (defaults to 0).
+ * Slaves both ref and dst to registers, then emits a sw instruction
+ * using constant-offset addressing mode y(rx) which writes to the address
+ * at an offset of y bytes from the address currently contained in rx.
+ */
+void Mips::EmitStore(Location *reference, Location *value, int offset)
+{
+  Register val = GetRegister(value, ForRead, rs);
+  Register base = GetRegister(reference, ForRead, rd);
+  Emit("sw %s, %d(%s) \t# store with offset",
+	 regs[val].name, offset, regs[base].name);
+}
+
+
+/* Method: EmitBinaryOp
+ * --------------------
+ * Used to perform a binary operation on 2 operands and store result
+ * in dst. All binary forms for arithmetic, logical, relational, equality
+ * use this method. Slaves both operands and dst to registers, then
+ * emits the appropriate instruction by looking up the mips name
+ * for the particular op code.
+ */
+void Mips::EmitBinaryOp(BinaryOp::OpCode code, Location *dst, 
+				 Location *op1, Location *op2)
+{
+  Register r1 = GetRegister(op1, ForRead, rs);
+  Register r2 = GetRegister(op2, ForRead, rt);
+  Register r = GetRegister(dst, ForWrite, rd);
+  Emit("%s %s, %s, %s\t", NameForTac(code), regs[r].name,
+	 regs[r1].name, regs[r2].name);
+  WriteBack(dst, r);
+}
+
+/* Method: EmitAddImm
+ * ------------------
+ * Adds a constant to src, as an addi (which, like the add used for
+ * BinaryOp::Add, traps on overflow). When src and dst share a register
+ * this is the whole of an increment.
+ */
+void Mips::EmitAddImm(Location *dst, Location *src, int imm)
+{
+  Register r1 = GetRegister(src, ForRead, rs);
+  Register r = GetRegister(dst, ForWrite, rd);
+  Emit("addi %s, %s, %d\t", regs[r].name, regs[r1].name, imm);
+  WriteBack(dst, r);
+}
+
+
+/* Method: EmitLabel
+ * -----------------
+ * Used to emit label marker. Before a label, we spill all registers since
+ * we can't be sure what the situation upon arriving at this label (ie
+ * starts new basic block), and rather than try to be clever, we just
+ * wipe the slate clean.
+ */
+void Mips::EmitLabel(const char *label)
+{
+ 
+  Emit("%s:", label);
+}
+
+
+/* Method: EmitGoto
+ * ----------------
+ * Used for an unconditional transfer to a named label. Before a goto,
+ * we spill all registers, since we don't know what the situation is
+ * we are heading to (ie this ends current basic block) and rather than
+ * try to be clever, we just wipe slate clean.
+ */
+void Mips::EmitGoto(const char *label)
+{
+ 
+  Emit("b %s\t\t# unconditional branch", label);
+}
+
+
+/* Method: EmitIfZ
+ * ---------------
+ * Used for a conditional branch based on value of test variable.
+ * We slave test var to register and use in the emitted test instruction,
+ * either beqz. See comments above on Goto for why we spill
+ * all registers here.
+ */
+void Mips::EmitIfZ(Location *test, const char *label)
+{
+  Register r = GetRegister(test, ForRead, rs);
+  Emit("beqz %s, %s\t# branch if %s is zero ", regs[r].name, label,
+	 test->GetName());
+}
+
+
+/* Method: EmitIfCmp
+ * -----------------
+ * Used for a fused compare and branch. Both operands go straight into
+ * a MIPS branch on their relation (blt, bge, etc.), so no boolean is
+ * ever materialized.
+ */
+void Mips::EmitIfCmp(BinaryOp::OpCode rel, Location *op1, Location *op2,
+		     const char *label)
+{
+  Assert(rel >= 0 && rel < BinaryOp::NumOps && branchName[rel] != NULL);
+  Register r1 = GetRegister(op1, ForRead, rs);
+  Register r2 = GetRegister(op2, ForRead, rt);
+  Emit("%s %s, %s, %s\t# branch if %s %s %s", branchName[rel],
+       regs[r1].name, regs[r2].name, label, op1->GetName(),
+       BinaryOp::opName[rel], op2->GetName());
+}
+
+
+/* Method: EmitParam
+ * -----------------
+ * Used to pass a parameter in anticipation of upcoming function call.
+ * An arg that goes in a register is slaved straight into its $a
+ * register. The others go on the stack, where the first one pushed
+ * (the call's last) makes space for all of them at once; each is
+ * stored to its slot, counting up from 4 above the new $sp.
+ */
+void Mips::EmitParam(Location *arg, int slot, int numSlots, bool viaRegs)
+{ 
+  if (viaRegs && slot < NumArgRegs) {
+    Register a = (Register)(a0 + slot);
+    Register r = GetRegister(arg, ForRead, a);
+    if (r != a)
+      Emit("move %s, %s\t\t# pass param in %s", regs[a].name, regs[r].name,
+	   regs[a].name);
+    return;
+  }
+  if (viaRegs) {
+    slot -= NumArgRegs;
+    numSlots -= NumArgRegs;
+  }
+  if (slot == numSlots - 1)
+    Emit("subu $sp, $sp, %d\t# decrement sp to make space for params",
+	 4 * numSlots);
+  Register r = GetRegister(arg, ForRead, rs);
+  Emit("sw %s, %d($sp)\t# copy param value to stack", regs[r].name,
+       4 * (slot + 1));
+}
+
+
+/* Method: EmitCallInstr
+ * ---------------------
+ * Used to effect a function call. All necessary arguments should have
+ * already been pushed on the stack, this is the last step that
+ * transfers control from caller to callee.  See comments on Goto method
+ * above for why we spill all registers before making the jump. We issue
+ * jal for a label, a jalr if address in register. Both will save the
+ * return address in $ra. If there is an expected result passed, we slave
+ * the var to a register and copy function return value from $v0 into that
+ * register.  
+ */
+void Mips::EmitCallInstr(Location *result, const char *fn, bool isLabel)
+{
+  Emit("%s %-15s\t# jump to function", isLabel? "jal": "jalr", fn);
+  if (result != NULL) {
+    if (varRegs.count(result))
+      Emit("move %s, %s\t\t# copy function return value from $v0",
+	   regs[varRegs[result]].name, regs[v0].name);
+    else
+      SpillRegister(result, v0);
+  }
+}
+
+
+// Two covers for the above method for specific LCall/ACall variants
+void Mips::EmitLCall(Location *dst, const char *label)
+{ 
+  EmitCallInstr(dst, label, true);
+}
+
+void Mips::EmitACall(Location *dst, Location *fn)
+{
+  Register r = GetRegister(fn, ForRead, rs);
+  EmitCallInstr(dst, regs[r].name, false);
+}
+
+/*
+ * We remove all parameters from the stack after a completed call
+ * by adjusting the stack pointer upwards.
+ */
+void Mips::EmitPopParams(int bytes)
+{
+  if (bytes != 0)
+    Emit("add $sp, $sp, %d\t# pop params off stack", bytes);
+}
+
+
+/* Method: EmitJumpTable
+ * ---------------------
+ * Used to emit a multi-way branch. The table of labels goes in the data
+ * segment, then the index is scaled to a byte offset into it and the
+ * label found there is jumped to.
+ */
+void Mips::EmitJumpTable(Location *index, const char *table,
+			 const std::vector<const char*> &labels)
+{
+  Emit(".data");
+  Emit(".align 2");
+  Emit("%s:\t\t# jump table", table);
+  for (int i = 0; i < labels.size(); i++)
+    Emit(".word %s", labels[i]);
+  Emit(".text");
+  Register r = GetRegister(index, ForRead, rs);
+  Emit("sll %s, %s, 2\t# scale index to table offset", regs[rd].name, regs[r].name);
+  Emit("la %s, %s\t# load address of jump table", regs[rt].name, table);
+  Emit("addu %s, %s, %s\t", regs[rd].name, regs[rd].name, regs[rt].name);
+  Emit("lw %s, 0(%s)\t# load target label", regs[rd].name, regs[rd].name);
+  Emit("jr %s\t\t# jump through table", regs[rd].name);
+}
+
+/* Method: EmitReturn
+ * ------------------
+ * Used to emit code for returning from a function (either from an
+ * explicit return or falling off the end of the function body).
+ * If there is an expression to return, we slave that variable into
+ * a register and move its contents to $v0 (the standard register for
+ * function result).  Before exiting, we spill dirty registers (to
+ * commit contents of slaved registers to memory, necessary for
+ * consistency, see comments at SpillForEndFunction above). We also
+ * do the last part of the callee's job in function call protocol,
+ * which is to remove our locals/temps from the stack, remove
+ * saved registers ($fp and $ra) and restore previous values of
+ * $fp and $ra so everything is returned to the state we entered.
+ * We then emit jr to jump to the saved $ra.
+ */
+ void Mips::EmitReturn(Location *returnVal)
+{ 
+  if (returnVal != NULL) 
+    {
+      if (varRegs.count(returnVal))
+	Emit("move $v0, %s\t\t# assign return value into $v0",
+	     regs[varRegs[returnVal]].name);
+      else
+	FillRegister(returnVal, v0);
+    }
+  if (!frameless)
+    EmitPopFrame();
+  Emit("jr $ra\t\t# return from function");
+}
+
+/* Method: EmitPopFrame
+ * --------------------
+ * The part of returning that undoes EmitBeginFunction: restores the
+ * callee-saved registers, $sp, $ra and $fp to their values on entry.
+ */
+void Mips::EmitPopFrame()
+{
+  for (int i = 0; i < savedRegs.size(); i++)
+    Emit("lw %s, %d($fp)\t# restore callee-saved %s", regs[savedRegs[i]].name,
+	 SavedRegOffset(i), regs[savedRegs[i]].name);
+  if (homeSize)
+    Emit("addiu $sp, $fp, %d\t# pop callee frame off stack", homeSize);
+  else
+    Emit("move $sp, $fp\t\t# pop callee frame off stack");
+  Emit("lw $ra, -4($fp)\t# restore saved ra");
+  Emit("lw $fp, 0($fp)\t# restore saved fp");
+}
+
+/* Method: EmitTailCall
+ * --------------------
+ * Used to emit a call in tail position. The args (no more than fit in
+ * registers) are passed in $a registers as usual, then our frame is
+ * popped. With $ra still holding our caller's return address, we just
+ * jump to the callee, and it returns to our caller directly.
+ */
+void Mips::EmitTailCall(const char *label, const std::vector<Location*> &args)
+{
+  Assert(args.size() <= NumArgRegs);
+  for (int i = 0; i < args.size(); i++) {
+    Register a = (Register)(a0 + i);
+    Register r = GetRegister(args[i], ForRead, a);
+    if (r != a)
+      Emit("move %s, %s\t\t# pass param in %s", regs[a].name, regs[r].name,
+	   regs[a].name);
+  }
+  EmitPopFrame();
+  Emit("j %s\t\t# tail call, callee returns to our caller", label);
+}
+
+
+/* Method: EmitBeginFunction
+ * -------------------------
+ * Used to handle the callee's part of the function call protocol
+ * upon entering a new function. We decrement the $sp, once, to make
+ * space to save the current values of $fp and $ra (since we are going
+ * to change them) and for all our locals/temps, save $fp and $ra and
+ * set up the new $fp. The callee-saved registers
+ * the allocator handed out are saved just below the locals/temps.
+ *
+ * The params passed in $a0-$a3 are moved to the registers they live
+ * in. If one got no register, it is stored to its slot above $fp,
+ * which is then in a home area of NumArgRegs words that we make for
+ * them between our caller's $sp and our saved $fp. That also puts the
+ * params passed on the stack, which the caller pushed starting at
+ * 4($sp), where the params after the first NumArgRegs are expected.
+ *
+ * A leaf function (one that makes no calls) whose locals/temps and
+ * params all got $t registers needs none of that: $ra is never
+ * overwritten and nothing is kept on the stack. Such a function gets
+ * no frame at all.
+ */
+void Mips::EmitBeginFunction(int stackFrameSize)
+{
+  Assert(stackFrameSize >= 0);
+  frameSize = stackFrameSize;
+  homeSize = 0;
+  for (int i = 0; i < params.size(); i++)
+    if (params[i]->GetOffset() > 4 * NumArgRegs || !varRegs.count(params[i]))
+      homeSize = 4 * NumArgRegs;
+  frameless = isLeaf && frameSize == 0 && homeSize == 0 && savedRegs.empty();
+  stackFrameSize += savedRegs.size() * 4;
+  int fpOffset = 8 + stackFrameSize;   // from the new $sp to the new $fp
+  if (frameless)
+    Emit("# (leaf function, no frame needed)");
+  else {
+    Emit("subu $sp, $sp, %d\t# decrement sp to make space for ra, fp, locals/temps",
+	 fpOffset + homeSize);
+    Emit("sw $fp, %d($sp)\t# save fp", fpOffset);
+    Emit("sw $ra, %d($sp)\t# save ra", fpOffset - 4);
+    Emit("addiu $fp, $sp, %d\t# set up new fp", fpOffset);
+  }
+  for (int i = 0; i < savedRegs.size(); i++)
+    Emit("sw %s, %d($fp)\t# save callee-saved %s", regs[savedRegs[i]].name,
+	 SavedRegOffset(i), regs[savedRegs[i]].name);
+  for (int i = 0; i < params.size(); i++) {
+    Location *param = params[i];
+    int slot = param->GetOffset() / 4 - 1;
+    bool inReg = varRegs.count(param) > 0;
+    if (slot >= NumArgRegs) {
+      if (inReg) FillRegister(param, varRegs[param]);
+    } else if (inReg)
+      Emit("move %s, %s\t\t# param %s passed in %s", regs[varRegs[param]].name,
+	   regs[a0 + slot].name, param->GetName(), regs[a0 + slot].name);
+    else
+      SpillRegister(param, (Register)(a0 + slot));
+  }
+}
+
+
+/* Method: EmitEndFunction
+ * -----------------------
+ * Used to end the body of a function. Does an implicit return in fall off
+ * case to clean up stack frame, return to caller etc. See comments on
+ * EmitReturn above.
+ */
+void Mips::EmitEndFunction()
+{ 
+  Emit("# (below handles reaching end of fn body with no explicit return)");
+  EmitReturn(NULL);
+}
+
+
+
+/* Method: EmitVTable
+ * ------------------
+ * Used to layout a vtable. Uses assembly directives to set up new
+ * entry in data segment, emits label, and lays out the function
+ * labels one after another. The class's pointer map comes just
+ * before the label, read backwards by the collector: the number of
+ * pointer fields, then their offsets in the object.
+ */
+void Mips::EmitVTable(const char *label, List<const char*> *methodLabels,
+                      const std::vector<int> &pointerFields)
+{
+  Emit(".data");
+  Emit(".align 2");
+  for (int i = pointerFields.size() - 1; i >= 0; i--)
+    Emit(".word %d\t\t# pointer field", pointerFields[i]);
+  Emit(".word %d\t\t# pointer fields of %s", (int)pointerFields.size(), label);
+  Emit("%s:\t\t# label for class %s vtable", label, label);
+  for (int i = 0; i < methodLabels->NumElements(); i++)
+    Emit(".word %s\n", methodLabels->Nth(i));
+  Emit(".text");
+}
+
+
+/* Method: EmitGlobalPointerMap
+ * ------------------------------
+ * Lays out the table the collector reads to find the globals that
+ * hold pointers: their number, then their offsets from $gp.
+ */
+void Mips::EmitGlobalPointerMap(const std::vector<int> &offsets)
+{
+  Emit(".data");
+  Emit(".align 2");
+  Emit("_GlobalPointers:\t# globals the collector traces");
+  Emit(".word %d", (int)offsets.size());
+  for (int i = 0; i < offsets.size(); i++)
+    Emit(".word %d", offsets[i]);
+  Emit(".text");
+}
+
+
+std::string Mips::StringValue(const char *quoted)
+{
+  std::string value;
+  int len = strlen(quoted) - 1;
+  for (int i = 1; i < len; i++) {
+    if (quoted[i] == '\\' && i + 1 < len) {
+      i++;
+      value += quoted[i] == 'n' ? '\n' : quoted[i] == 't' ? '\t' : quoted[i];
+    } else
+      value += quoted[i];
+  }
+  return value;
+}
+
+/* Method: EmitStringPool
+ * ----------------------
+ * Used to lay out the program's string constants, one null-terminated
+ * copy of each under its label, in a single block of the data segment.
+ * Like the strings _ReadLine makes, each starts on a word, has its
+ * length in the word before it and is padded with zeros to a whole
+ * number of words, so _StringEqual can compare a word at a time. The
+ * length counts an escape such as \n as the one character it stands for.
+ */
+void Mips::EmitStringPool(const std::vector<std::pair<const char*, const char*> > &pool)
+{
+  if (pool.empty()) return;
+  Emit(".data\t\t\t# string constants");
+  for (int i = 0; i < pool.size(); i++) {
+    Emit(".align 2");
+    Emit(".word %d", (int)StringValue(pool[i].second).size());
+    Emit("%s: .asciiz %s", pool[i].first, pool[i].second);
+  }
+  Emit(".align 2");
+  Emit(".text");
+}
+
+
+/* Method: EmitPreamble
+ * --------------------
+ * Used to emit the starting sequence needed for a program. Not much
+ * here, but need to indicate what follows is in text segment and
+ * needs to be aligned on word boundary. main is our only global symbol.
+ */
+void Mips::EmitPreamble()
+{
+  Emit("# standard Decaf preamble ");
+  Emit(".text");
+  Emit(".align 2");
+  Emit(".globl main");
+}
+
+
+/* Method: NameForTac
+ * ------------------
+ * Returns the appropriate MIPS instruction (add, seq, etc.) for
+ * a given BinaryOp:OpCode (BinaryOp::Add, BinaryOp:Equals, etc.). 
+ * Asserts if asked for name of an unset/out of bounds code.
+ */
+const char *Mips::NameForTac(BinaryOp::OpCode code)
+{
+  Assert(code >=0 && code < BinaryOp::NumOps);
+  const char *name = mipsName[code];
+  Assert(name != NULL);
+  return name;
+}
+
+/* Constructor
+ * ----------
+ * Constructor sets up the mips names and register descriptors to
+ * the initial starting state.
+ */
+Mips::Mips() {
+  isLeaf = frameless = false;
+  homeSize = 0;
+  mipsName[BinaryOp::Add] = "add";
+  mipsName[BinaryOp::Sub] = "sub";
+  mipsName[BinaryOp::Mul] = "mul";
+  mipsName[BinaryOp::Div] = "div";
+  mipsName[BinaryOp::Mod] = "rem";
+  mipsName[BinaryOp::Eq] = "seq";
+  mipsName[BinaryOp::Less] = "slt";
+  mipsName[BinaryOp::And] = "and";
+  mipsName[BinaryOp::Or] = "or";
+  mipsName[BinaryOp::NotEq] = "sne";
+  mipsName[BinaryOp::LessEq] = "sle";
+  mipsName[BinaryOp::Greater] = "sgt";
+  mipsName[BinaryOp::GreaterEq] = "sge";
+  mipsName[BinaryOp::UnsignedGreaterEq] = "sgeu";
+  mipsName[BinaryOp::UnsignedSub] = "subu";
+  branchName[BinaryOp::Eq] = "beq";
+  branchName[BinaryOp::NotEq] = "bne";
+  branchName[BinaryOp::Less] = "blt";
+  branchName[BinaryOp::LessEq] = "ble";
+  branchName[BinaryOp::Greater] = "bgt";
+  branchName[BinaryOp::GreaterEq] = "bge";
+  branchName[BinaryOp::UnsignedGreaterEq] = "bgeu";
+  regs[zero] = (RegContents){false, NULL, "$zero", false};
+  regs[at] = (RegContents){false, NULL, "$at", false};
+  regs[v0] = (RegContents){false, NULL, "$v0", false};
+  regs[v1] = (RegContents){false, NULL, "$v1", false};
+  regs[a0] = (RegContents){false, NULL, "$a0", false};
+  regs[a1] = (RegContents){false, NULL, "$a1", false};
+  regs[a2] = (RegContents){false, NULL, "$a2", false};
+  regs[a3] = (RegContents){false, NULL, "$a3", false};
+  regs[k0] = (RegContents){false, NULL, "$k0", false};
+  regs[k1] = (RegContents){false, NULL, "$k1", false};
+  regs[gp] = (RegContents){false, NULL, "$gp", false};
+  regs[sp] = (RegContents){false, NULL, "$sp", false};
+  regs[fp] = (RegContents){false, NULL, "$fp", false};
+  regs[ra] = (RegContents){false, NULL, "$ra", false};
+  regs[t0] = (RegContents){false, NULL, "$t0", true};
+  regs[t1] = (RegContents){false, NULL, "$t1", true};
+  regs[t2] = (RegContents){false, NULL, "$t2", true};
+  regs[t3] = (RegContents){false, NULL, "$t3", true};
+  regs[t4] = (RegContents){false, NULL, "$t4", true};
+  regs[t5] = (RegContents){false, NULL, "$t5", true};
+  regs[t6] = (RegContents){false, NULL, "$t6", true};
+  regs[t7] = (RegContents){false, NULL, "$t7", true};
+  regs[t8] = (RegContents){false, NULL, "$t8", true};
+  regs[t9] = (RegContents){false, NULL, "$t9", true};
+  regs[s0] = (RegContents){false, NULL, "$s0", true};
+  regs[s1] = (RegContents){false, NULL, "$s1", true};
+  regs[s2] = (RegContents){false, NULL, "$s2", true};
+  regs[s3] = (RegContents){false, NULL, "$s3", true};
+  regs[s4] = (RegContents){false, NULL, "$s4", true};
+  regs[s5] = (RegContents){false, NULL, "$s5", true};
+  regs[s6] = (RegContents){false, NULL, "$s6", true};
+  regs[s7] = (RegContents){false, NULL, "$s7", true};
+  rs = t0; rt = t1; rd = t2;
+  frameSize = 0;
+
+}
+const char *Mips::mipsName[BinaryOp::NumOps];
+const char *Mips::branchName[BinaryOp::NumOps];
+
+const Mips::Register Mips::callerSaved[] = {t3, t4, t5, t6, t7, t8, t9};
+const Mips::Register Mips::calleeSaved[] = {s0, s1, s2, s3, s4, s5, s6, s7};
+const int Mips::NumCallerSaved = sizeof(callerSaved) / sizeof(callerSaved[0]);
+const int Mips::NumCalleeSaved = sizeof(calleeSaved) / sizeof(calleeSaved[0]);
+
+
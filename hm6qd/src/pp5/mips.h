@@ -0,0 +1,162 @@
+/* File: mips.h
+ * ------------
+ * The Mips class defines an object capable of emitting MIPS
+ * instructions and managing the allocation and use of registers.
+ * It is used by the Tac instruction classes to convert each
+ * instruction to the appropriate MIPS equivalent.
+ *
+ * You can scan this code to see it works and get a sense of what
+ * it does.  You will not need to modify this class unless
+ * you're attempting some machine-specific optimizations. 
+ *
+ * It comments the emitted assembly but the commenting for the code
+ * in the class itself is pretty sparse. The SPIM manual (see link
+ * from other materials on our web site) has more detailed documentation
+ * on the MIPS architecture, instruction set, calling conventions, etc.
+ */
+
+#ifndef _H_mips
+#define _H_mips
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tac.h"
+#include "list.h"
+class Location;
+class LiveInterval;
+
+
+class Mips {
+  private:
+    typedef enum {zero, at, v0, v1, a0, a1, a2, a3,
+			s0, s1, s2, s3, s4, s5, s6, s7,
+			t0, t1, t2, t3, t4, t5, t6, t7,
+			t8, t9, k0, k1, gp, sp, fp, ra, NumRegs } Register;
+
+    struct RegContents {
+	bool isDirty;
+	Location *var;
+	const char *name;
+	bool isGeneralPurpose;
+    } regs[NumRegs];
+
+    Register rs, rt, rd;
+
+    typedef enum { ForRead, ForWrite } Reason;
+    
+    void FillRegister(Location *src, Register reg);
+    void SpillRegister(Location *dst, Register reg);
+
+        // Register allocation state for the function being emitted:
+        // the register each register-resident variable lives in, the
+        // params the function refers to (which the prologue moves from
+        // $a0-$a3 or the stack to where they live), and the
+        // callee-saved registers the prologue must preserve.
+    std::map<Location*, Register> varRegs;
+    std::vector<Location*> params;
+    std::vector<Register> savedRegs;
+    int frameSize;
+    bool isLeaf;        // the function makes no calls
+    bool frameless;     // ... and needs no stack either: see EmitBeginFunction
+    int homeSize;       // bytes kept above $fp for params passed in registers
+
+    static const Register callerSaved[], calleeSaved[];
+    static const int NumCallerSaved, NumCalleeSaved;
+
+    bool IsCalleeSaved(Register reg);
+    int SavedRegOffset(int i) { return -8 - frameSize - 4 * i; }
+    Register GetRegister(Location *var, Reason reason, Register scratch);
+    void WriteBack(Location *dst, Register reg);
+
+    void EmitCallInstr(Location *dst, const char *fn, bool isL);
+    void EmitPopFrame();
+    
+    static const char *mipsName[BinaryOp::NumOps];
+    static const char *branchName[BinaryOp::NumOps];
+    static const char *NameForTac(BinaryOp::OpCode code);
+
+    Instruction* currentInstruction;
+ public:
+        // Calls to compiled functions pass their first NumArgRegs args
+        // in $a0-$a3; the rest, and all args to built-ins, go on the
+        // stack.
+    static const int NumArgRegs = 4;
+
+    Mips();
+
+    static void Emit(const char *fmt, ...);
+
+        // The characters a quoted string literal stands for, with its
+        // escapes (\n, \t, \", \\) read as the assembler reads them
+    static std::string StringValue(const char *quoted);
+
+    void AllocateRegisters(const std::vector<LiveInterval*> &intervals);
+    bool IsInRegister(Location *var) { return varRegs.count(var) > 0; }
+    void SetLeafFunction(bool leaf) { isLeaf = leaf; }
+    
+    void EmitLoadConstant(Location *dst, int val);
+    void EmitLoadStringConstant(Location *dst, const char *label);
+    void EmitLoadLabel(Location *dst, const char *label);
+
+    void EmitLoad(Location *dst, Location *reference, int offset);
+    void EmitStore(Location *reference, Location *value, int offset);
+    void EmitCopy(Location *dst, Location *src);
+
+    void EmitBinaryOp(BinaryOp::OpCode code, Location *dst, 
+			    Location *op1, Location *op2);
+    void EmitAddImm(Location *dst, Location *src, int imm);
+
+    void EmitLabel(const char *label);
+    void EmitGoto(const char *label);
+    void EmitIfZ(Location *test, const char*label);
+    void EmitIfCmp(BinaryOp::OpCode rel, Location *op1, Location *op2,
+		   const char *label);
+    void EmitJumpTable(Location *index, const char *table,
+		       const std::vector<const char*> &labels);
+    void EmitReturn(Location *returnVal);
+    void EmitTailCall(const char *label, const std::vector<Location*> &args);
+
+    void EmitBeginFunction(int frameSize);
+    void EmitEndFunction();
+
+    void EmitParam(Location *arg, int slot, int numSlots, bool inRegister);
+    void EmitLCall(Location *result, const char* label);
+    void EmitACall(Location *result, Location *fnAddr);
+    void EmitPopParams(int bytes);
+
+    void EmitVTable(const char *label, List<const char*> *methodLabels,
+                    const std::vector<int> &pointerFields);
+    void EmitStringPool(const std::vector<std::pair<const char*, const char*> > &pool);
+    void EmitGlobalPointerMap(const std::vector<int> &offsets);
+
+    void EmitPreamble();
+
+  
+    class CurrentInstruction;
+};
+
+
+// Adds CurrentInstruction to the Mips object
+class Mips::CurrentInstruction
+{
+public:
+  CurrentInstruction(Mips& mips, Instruction* instr)
+    : mips( mips )
+  {
+    mips.currentInstruction= instr;
+  }
+
+  ~CurrentInstruction()
+  {
+    mips.currentInstruction= NULL;
+  }
+
+private:
+  Mips& mips;
+};
+
+
+#endif
+ 
@@ -0,0 +1,720 @@
+/* File: mipssim.cc
+ * ----------------
+ * Implementation of the MipsSimulator class.
+ */
+
+#include "mipssim.h"
+#include <cctype>
+#include <climits>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const unsigned TextBase = 0x00400000;
+const unsigned DataBase = 0x10000000;   // the global area is in its 64K
+const unsigned DataStart = 0x10010000;
+const unsigned GlobalPointer = 0x10008000;
+const unsigned StackTop = 0x80000000u;
+const unsigned StackSize = 64 << 20;
+const unsigned MaxData = 512 << 20;
+
+typedef enum { Three, Two, Immediate, LoadAddress, Memory, Branch2, Branch1,
+               Jump, JumpReg, NoOperands } Format;
+
+   // Each mnemonic's opcode (an int as the enum is private) and operands.
+   // The immediate and variable forms share the opcode of the plain one.
+struct Mnemonic {
+  const char *name;
+  int op;
+  Format format;
+};
+
+const char *exceptionNames[] = {
+  "  [Interrupt] ", "", "", "",
+  "  [Unaligned address in inst/data fetch] ",
+  "  [Unaligned address in store] ", "  [Bad address in text read] ",
+  "  [Bad address in data/stack read] ", "  [Error in syscall] ",
+  "  [Breakpoint] ", "  [Reserved instruction] ", "",
+  "  [Arithmetic overflow] "};
+
+const char *registerNames[] = {
+  "zero", "at", "v0", "v1", "a0", "a1", "a2", "a3",
+  "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+  "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+  "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra"};
+
+enum { V0 = 2, A0 = 4, A1 = 5, GP = 28, SP = 29, RA = 31 };
+
+std::string Trim(const std::string &s)
+{
+  size_t start = s.find_first_not_of(" \t\r\n");
+  if (start == std::string::npos) return "";
+  return s.substr(start, s.find_last_not_of(" \t\r\n") - start + 1);
+}
+
+std::string StripComment(const std::string &s)
+{
+  bool quoted = false;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '\\' && quoted) i++;
+    else if (s[i] == '"') quoted = !quoted;
+    else if (s[i] == '#' && !quoted) return s.substr(0, i);
+  }
+  return s;
+}
+
+   // Splits operands on commas and, as trap.handler does without the
+   // commas, on white space.
+std::vector<std::string> SplitOperands(const std::string &s)
+{
+  std::vector<std::string> operands;
+  std::string current;
+  for (size_t i = 0; i <= s.size(); i++) {
+    if (i == s.size() || s[i] == ',' || isspace((unsigned char)s[i])) {
+      if (!current.empty()) operands.push_back(current);
+      current.clear();
+    } else current += s[i];
+  }
+  return operands;
+}
+
+}
+
+MipsSimulator::MipsSimulator()
+  : brk(0), pc(0), halted(false), exitCode(0), numInstrs(0),
+    branchesTaken(0), heapBytes(0), sbrkBytes(0), heapNext(0)
+{
+  memset(regs, 0, sizeof(regs));
+  memset(classCounts, 0, sizeof(classCounts));
+}
+
+bool MipsSimulator::LoadFile(const char *file)
+{
+  FILE *fp = fopen(file, "r");
+  if (!fp) return false;
+  char buf[4096];
+  int number = 0;
+  while (fgets(buf, sizeof(buf), fp)) {
+    Line l;
+    l.text = buf;
+    l.file = file;
+    l.number = ++number;
+    lines.push_back(l);
+  }
+  fclose(fp);
+  return true;
+}
+
+void MipsSimulator::Error(int line, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  if (line >= 0)
+    fprintf(stderr, "msim: %s:%d: ", lines[line].file.c_str(), lines[line].number);
+  else fprintf(stderr, "msim: ");
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+  exit(2);
+}
+
+/* Method: Assemble
+ * ----------------
+ * Assembles all the lines loaded in two passes. The first lays out the
+ * data and gives each label its address, collecting the text statements
+ * as they are; the second, once all labels are known, decodes them.
+ * The startup code of trap.handler goes first in the text.
+ */
+void MipsSimulator::Assemble()
+{
+  const char *startup[][3] = {{"jal", "main", NULL}, {"li", "$v0", "10"},
+                              {"syscall", NULL, NULL}};
+  for (int i = 0; i < 3; i++) {
+    Statement s;
+    s.mnemonic = startup[i][0];
+    for (int j = 1; j < 3 && startup[i][j]; j++) s.operands.push_back(startup[i][j]);
+    s.line = -1;
+    statements.push_back(s);
+  }
+  data.resize(DataStart - DataBase);
+
+  enum { TextSegment, DataSegment, KernelSegment } segment = TextSegment;
+  for (int i = 0; i < (int)lines.size(); i++) {
+    std::string s = Trim(StripComment(lines[i].text));
+    size_t colon;
+    while ((colon = s.find(':')) != std::string::npos && s.find('"') > colon) {
+      std::string label = Trim(s.substr(0, colon));
+      if (label.empty() || label.find_first_of(" \t") != std::string::npos) break;
+      if (segment != KernelSegment) {
+        if (labels.count(label)) Error(i, "label %s is defined twice", label.c_str());
+        labels[label] = segment == TextSegment ? TextBase + 4 * statements.size()
+                                               : DataBase + data.size();
+      }
+      s = Trim(s.substr(colon + 1));
+    }
+    if (s.empty()) continue;
+
+    size_t end = s.find_first_of(" \t");
+    std::string name = s.substr(0, end);
+    std::string rest = end == std::string::npos ? "" : Trim(s.substr(end));
+    if (name == ".text") segment = TextSegment;
+    else if (name == ".data") segment = DataSegment;
+    else if (name == ".ktext" || name == ".kdata") segment = KernelSegment;
+    else if (segment == KernelSegment) continue;
+    else if (name == ".globl" || name == ".set" || name == ".extern") continue;
+    else if (name[0] == '.') {
+      if (segment == TextSegment && name != ".align")
+        Error(i, "%s is only allowed in the data segment", name.c_str());
+      if (segment == DataSegment) Directive(name, rest, i);
+    } else {
+      if (segment == DataSegment) Error(i, "instruction %s in the data segment", name.c_str());
+      Statement st;
+      st.mnemonic = name;
+      st.operands = SplitOperands(rest);
+      st.line = i;
+      statements.push_back(st);
+    }
+  }
+
+  for (size_t i = 0; i < wordFixups.size(); i++) {
+    int value = Value(wordFixups[i].second, -1);
+    memcpy(&data[wordFixups[i].first], &value, 4);
+  }
+  data.resize((data.size() + 3) & ~3);
+  brk = DataBase + data.size();
+  for (size_t i = 0; i < statements.size(); i++)
+    Decode(statements[i]);
+}
+
+/* Method: Directive
+ * -----------------
+ * Lays out what a data directive holds at the end of the data.
+ */
+void MipsSimulator::Directive(const std::string &name, const std::string &rest, int line)
+{
+  if (name == ".align") {
+    int n = Value(rest, line);
+    if (n < 0 || n > 16) Error(line, "bad alignment %d", n);
+    data.resize((data.size() + (1 << n) - 1) & ~((1 << n) - 1));
+  } else if (name == ".space") {
+    data.resize(data.size() + Value(rest, line));
+  } else if (name == ".word" || name == ".half" || name == ".byte") {
+    int size = name == ".word" ? 4 : name == ".half" ? 2 : 1;
+    data.resize((data.size() + size - 1) & ~(size - 1));   // as SPIM aligns them
+    std::vector<std::string> values = SplitOperands(rest);
+    for (size_t i = 0; i < values.size(); i++) {
+      const char *v = values[i].c_str();
+      int value = 0;
+      if (isdigit((unsigned char)v[0]) || v[0] == '-' || v[0] == '\'')
+        value = Value(values[i], line);
+      else if (size == 4) wordFixups.push_back(std::make_pair((int)data.size(), values[i]));
+      else Error(line, "label %s in %s", v, name.c_str());
+      for (int b = 0; b < size; b++) data.push_back((value >> (8 * b)) & 0xff);
+    }
+  } else if (name == ".ascii" || name == ".asciiz") {
+    if (rest.size() < 2 || rest[0] != '"' || rest[rest.size() - 1] != '"')
+      Error(line, "%s needs a quoted string", name.c_str());
+    for (size_t i = 1; i < rest.size() - 1; i++) {
+      char c = rest[i];
+      if (c == '\\' && i + 1 < rest.size() - 1) {
+        c = rest[++i];
+        if (c == 'n') c = '\n';
+        else if (c == 't') c = '\t';
+        else if (c == '0') c = '\0';
+      }
+      data.push_back(c);
+    }
+    if (name == ".asciiz") data.push_back(0);
+  } else Error(line, "unknown directive %s", name.c_str());
+  if (data.size() > MaxData) Error(line, "the data segment is too big");
+}
+
+/* Method: Decode
+ * --------------
+ * Decodes a statement into an Instr and adds it to the text. A three
+ * operand instruction given two, as in addi $t0, 4, uses its first
+ * operand as its first source too.
+ */
+void MipsSimulator::Decode(const Statement &s)
+{
+  static const Mnemonic mnemonics[] = {
+    {"add", Add, Three}, {"addi", Add, Three}, {"addu", Addu, Three},
+    {"addiu", Addu, Three}, {"sub", Sub, Three}, {"subu", Subu, Three},
+    {"and", And, Three}, {"andi", And, Three}, {"or", Or, Three},
+    {"ori", Or, Three}, {"xor", Xor, Three}, {"xori", Xor, Three},
+    {"nor", Nor, Three}, {"slt", Slt, Three}, {"slti", Slt, Three},
+    {"sltu", Sltu, Three}, {"sltiu", Sltu, Three}, {"seq", Seq, Three},
+    {"sne", Sne, Three}, {"sge", Sge, Three}, {"sgeu", Sgeu, Three},
+    {"sgt", Sgt, Three}, {"sgtu", Sgtu, Three}, {"sle", Sle, Three},
+    {"sleu", Sleu, Three}, {"sll", Sll, Three}, {"sllv", Sll, Three},
+    {"srl", Srl, Three}, {"srlv", Srl, Three}, {"sra", Sra, Three},
+    {"srav", Sra, Three}, {"mul", Mul, Three}, {"div", Div, Three},
+    {"divu", Divu, Three}, {"rem", Rem, Three}, {"remu", Remu, Three},
+    {"move", Move, Two}, {"neg", Neg, Two}, {"negu", Neg, Two}, {"not", Not, Two},
+    {"li", Li, Immediate}, {"lui", Lui, Immediate}, {"la", Li, LoadAddress},
+    {"lw", Lw, Memory}, {"lb", Lb, Memory}, {"lbu", Lbu, Memory},
+    {"lh", Lh, Memory}, {"lhu", Lhu, Memory}, {"sw", Sw, Memory},
+    {"sb", Sb, Memory}, {"sh", Sh, Memory},
+    {"beq", Beq, Branch2}, {"bne", Bne, Branch2}, {"blt", Blt, Branch2},
+    {"ble", Ble, Branch2}, {"bgt", Bgt, Branch2}, {"bge", Bge, Branch2},
+    {"bltu", Bltu, Branch2}, {"bleu", Bleu, Branch2}, {"bgtu", Bgtu, Branch2},
+    {"bgeu", Bgeu, Branch2}, {"beqz", Beqz, Branch1}, {"bnez", Bnez, Branch1},
+    {"bltz", Bltz, Branch1}, {"blez", Blez, Branch1}, {"bgtz", Bgtz, Branch1},
+    {"bgez", Bgez, Branch1}, {"b", J, Jump}, {"j", J, Jump}, {"jal", Jal, Jump},
+    {"jr", Jr, JumpReg}, {"jalr", Jalr, JumpReg}, {"syscall", Syscall, NoOperands},
+    {"nop", Nop, NoOperands}, {"break", Break, NoOperands}};
+  const int numMnemonics = sizeof(mnemonics) / sizeof(mnemonics[0]);
+
+  const Mnemonic *m = NULL;
+  for (int i = 0; i < numMnemonics && !m; i++)
+    if (s.mnemonic == mnemonics[i].name) m = &mnemonics[i];
+  if (!m) Error(s.line, "unknown instruction %s", s.mnemonic.c_str());
+
+  const std::vector<std::string> &o = s.operands;
+  int n = o.size();
+  Instr in;
+  in.op = (Opcode)m->op;
+  in.rd = in.rs = in.rt = 0;
+  in.useImm = false;
+  in.imm = in.target = 0;
+  in.line = s.line;
+  bool ok = true;
+  switch (m->format) {
+    case Three:
+      ok = n == 2 || n == 3;
+      if (!ok) break;
+      in.rd = Register(o[0], s.line);
+      in.rs = Register(o[n - 2], s.line);
+      if (IsRegister(o[n - 1])) in.rt = Register(o[n - 1], s.line);
+      else {
+        in.useImm = true;
+        in.imm = Value(o[n - 1], s.line);
+      }
+      break;
+    case Two:
+      if ((ok = n == 2)) {
+        in.rd = Register(o[0], s.line);
+        in.rs = Register(o[1], s.line);
+      }
+      break;
+    case Immediate:
+      if ((ok = n == 2)) {
+        in.rd = Register(o[0], s.line);
+        in.imm = Value(o[1], s.line);
+      }
+      break;
+    case LoadAddress:
+      if ((ok = n == 2)) {
+        in.rd = Register(o[0], s.line);
+        Address(o[1], &in, s.line);
+        if (in.rs != 0) {               // la $t0, 8($sp) is an add
+          in.op = Addu;
+          in.useImm = true;
+        }
+      }
+      break;
+    case Memory:
+      if ((ok = n == 2)) {
+        in.rd = Register(o[0], s.line);
+        Address(o[1], &in, s.line);
+      }
+      break;
+    case Branch2:
+      if ((ok = n == 3)) {
+        in.rs = Register(o[0], s.line);
+        if (IsRegister(o[1])) in.rt = Register(o[1], s.line);
+        else {
+          in.useImm = true;
+          in.imm = Value(o[1], s.line);
+        }
+        in.target = Target(o[2], s.line);
+      }
+      break;
+    case Branch1:
+      if ((ok = n == 2)) {
+        in.rs = Register(o[0], s.line);
+        in.target = Target(o[1], s.line);
+      }
+      break;
+    case Jump:
+      if ((ok = n == 1)) in.target = Target(o[0], s.line);
+      break;
+    case JumpReg:
+      ok = n == 1 || (n == 2 && in.op == Jalr);
+      if (!ok) break;
+      in.rd = n == 2 ? Register(o[0], s.line) : RA;
+      in.rs = Register(o[n - 1], s.line);
+      break;
+    case NoOperands:
+      ok = n == 0;
+      break;
+  }
+  if (!ok) Error(s.line, "wrong number of operands for %s", s.mnemonic.c_str());
+  text.push_back(in);
+}
+
+bool MipsSimulator::IsRegister(const std::string &operand)
+{
+  return !operand.empty() && operand[0] == '$';
+}
+
+int MipsSimulator::Register(const std::string &operand, int line)
+{
+  if (IsRegister(operand)) {
+    std::string name = operand.substr(1);
+    if (!name.empty() && isdigit((unsigned char)name[0])) {
+      int r = atoi(name.c_str());
+      if (r < 32) return r;
+    }
+    if (name == "s8") return 30;
+    for (int r = 0; r < 32; r++)
+      if (name == registerNames[r]) return r;
+  }
+  Error(line, "bad register %s", operand.c_str());
+  return 0;
+}
+
+/* Method: Value
+ * -------------
+ * Returns the value of a constant, decimal, hex or a character, or the
+ * address of a label.
+ */
+int MipsSimulator::Value(const std::string &operand, int line)
+{
+  const char *s = operand.c_str();
+  if (s[0] == '\'' && operand.size() >= 3) {
+    if (s[1] != '\\') return s[1];
+    return s[2] == 'n' ? '\n' : s[2] == 't' ? '\t' : s[2] == '0' ? 0 : s[2];
+  }
+  if (isdigit((unsigned char)s[0]) || s[0] == '-' || s[0] == '+') {
+    char *end;
+    long long value = strtoll(s, &end, 0);
+    if (*end == '\0') return (int)value;
+  } else {
+    std::map<std::string, int>::iterator it = labels.find(operand);
+    if (it != labels.end()) return it->second;
+  }
+  Error(line, "bad constant or undefined label %s", s);
+  return 0;
+}
+
+   // Sets instr's base register and offset from an operand that is
+   // offset($r), ($r), or an address by itself
+void MipsSimulator::Address(const std::string &operand, Instr *instr, int line)
+{
+  size_t paren = operand.find('(');
+  if (paren == std::string::npos) {
+    instr->rs = 0;
+    instr->imm = Value(operand, line);
+  } else {
+    if (operand[operand.size() - 1] != ')')
+      Error(line, "bad address %s", operand.c_str());
+    instr->rs = Register(operand.substr(paren + 1, operand.size() - paren - 2), line);
+    instr->imm = paren == 0 ? 0 : Value(operand.substr(0, paren), line);
+  }
+}
+
+int MipsSimulator::Target(const std::string &operand, int line)
+{
+  std::map<std::string, int>::iterator it = labels.find(operand);
+  if (it == labels.end() || (unsigned)it->second < TextBase || (unsigned)it->second >= DataBase)
+    Error(line, "%s is not a text label", operand.c_str());
+  return ((unsigned)it->second - TextBase) / 4;
+}
+
+MipsSimulator::InstrClass MipsSimulator::ClassOf(Opcode op)
+{
+  if (op >= Mul && op <= Remu) return MulDiv;
+  if (op >= Lw && op <= Lhu) return LoadClass;
+  if (op >= Sw && op <= Sh) return StoreClass;
+  if (op >= Beq && op <= Bgez) return BranchClass;
+  if (op == J || op == Jr) return JumpClass;
+  if (op == Jal || op == Jalr) return CallClass;
+  if (op == Syscall) return SyscallClass;
+  return Alu;
+}
+
+   // Returns where bytes at addr are in the data or the stack, or NULL
+unsigned char *MipsSimulator::Translate(unsigned addr, int bytes)
+{
+  unsigned long long end = (unsigned long long)addr + bytes;
+  if (addr >= DataBase && end <= DataBase + data.size())
+    return &data[addr - DataBase];
+  if (addr >= StackTop - StackSize && end <= StackTop) {
+    if (stack.empty()) stack.resize(StackSize);
+    return &stack[addr - (StackTop - StackSize)];
+  }
+  return NULL;
+}
+
+void MipsSimulator::Exception(int code)
+{
+  const int numNames = sizeof(exceptionNames) / sizeof(exceptionNames[0]);
+  fflush(stdout);
+  printf("  Exception %d %s occurred and ignored\n", code,
+         code < numNames ? exceptionNames[code] : "");
+}
+
+bool MipsSimulator::Load(unsigned addr, int bytes, bool isSigned, int *value)
+{
+  if (addr % bytes != 0) {
+    Exception(4);
+    return false;
+  }
+  unsigned char *p = Translate(addr, bytes);
+  if (!p) {
+    Exception(7);
+    return false;
+  }
+  if (bytes == 4) memcpy(value, p, 4);
+  else if (bytes == 2) {
+    unsigned short h;
+    memcpy(&h, p, 2);
+    *value = isSigned ? (short)h : h;
+  } else *value = isSigned ? (signed char)*p : *p;
+  return true;
+}
+
+bool MipsSimulator::Store(unsigned addr, int bytes, int value)
+{
+  if (addr % bytes != 0) {
+    Exception(5);
+    return false;
+  }
+  unsigned char *p = Translate(addr, bytes);
+  if (!p) {
+    Exception(7);
+    return false;
+  }
+  if (bytes == 4) {
+    if (addr == heapNext && heapNext) {
+      unsigned old;
+      memcpy(&old, p, 4);
+      if (old && (unsigned)value > old) heapBytes += (unsigned)value - old;
+    }
+    memcpy(p, &value, 4);
+  } else if (bytes == 2) {
+    unsigned short h = value;
+    memcpy(p, &h, 2);
+  } else *p = value;
+  return true;
+}
+
+/* Method: DoSyscall
+ * -----------------
+ * Does the syscall selected by $v0 as SPIM does. read_string reads up to
+ * $a1 - 1 characters, stopping after a newline, which it keeps.
+ */
+void MipsSimulator::DoSyscall()
+{
+  int a0 = regs[A0];
+  switch (regs[V0]) {
+    case 1:                             // print_int
+      printf("%d", a0);
+      break;
+    case 4:                             // print_string
+      for (unsigned addr = a0; ; addr++) {
+        unsigned char *p = Translate(addr, 1);
+        if (!p) {
+          Exception(7);
+          break;
+        }
+        if (!*p) break;
+        putchar(*p);
+      }
+      break;
+    case 5: {                           // read_int
+      fflush(stdout);
+      char buf[256];
+      regs[V0] = fgets(buf, sizeof(buf), stdin) ? atoi(buf) : 0;
+      break;
+    }
+    case 8: {                           // read_string
+      fflush(stdout);
+      int i = 0;
+      for (; i < regs[A1] - 1; i++) {
+        int c = getchar();
+        if (c == EOF) break;
+        Store(a0 + i, 1, c);
+        if (c == '\n') {
+          i++;
+          break;
+        }
+      }
+      if (regs[A1] > 0) Store(a0 + i, 1, 0);
+      break;
+    }
+    case 9: {                           // sbrk
+      unsigned bytes = (a0 + 3) & ~3;
+      if (a0 < 0 || data.size() + bytes > MaxData) {
+        fflush(stdout);
+        fprintf(stderr, "msim: out of memory (sbrk of %d bytes)\n", a0);
+        exitCode = 1;
+        halted = true;
+        break;
+      }
+      regs[V0] = brk;
+      data.resize(data.size() + bytes);
+      brk += bytes;
+      sbrkBytes += bytes;
+      break;
+    }
+    case 10:                            // exit
+      halted = true;
+      break;
+    case 11:                            // print_char
+      putchar(a0);
+      break;
+    case 12:                            // read_char
+      fflush(stdout);
+      regs[V0] = getchar();
+      break;
+    case 17:                            // exit2
+      exitCode = a0;
+      halted = true;
+      break;
+    default:
+      Exception(8);
+  }
+}
+
+/* Method: Step
+ * ------------
+ * Runs one instruction and moves pc on.
+ */
+void MipsSimulator::Step(const Instr &in)
+{
+  int a = regs[in.rs], b = in.useImm ? in.imm : regs[in.rt];
+  unsigned ua = a, ub = b;
+  int next = pc + 1, result = 0;
+  bool write = true;                    // result to rd
+  bool taken = false;
+
+  numInstrs++;
+  classCounts[ClassOf(in.op)]++;
+  switch (in.op) {
+    case Add: case Sub: {
+      long long r = in.op == Add ? (long long)a + b : (long long)a - b;
+      if (r != (int)r) {
+        Exception(12);
+        write = false;
+      } else result = (int)r;
+      break;
+    }
+    case Addu: result = ua + ub; break;
+    case Subu: result = ua - ub; break;
+    case And: result = a & b; break;
+    case Or: result = a | b; break;
+    case Xor: result = a ^ b; break;
+    case Nor: result = ~(a | b); break;
+    case Slt: result = a < b; break;
+    case Sltu: result = ua < ub; break;
+    case Seq: result = a == b; break;
+    case Sne: result = a != b; break;
+    case Sge: result = a >= b; break;
+    case Sgeu: result = ua >= ub; break;
+    case Sgt: result = a > b; break;
+    case Sgtu: result = ua > ub; break;
+    case Sle: result = a <= b; break;
+    case Sleu: result = ua <= ub; break;
+    case Sll: result = ua << (b & 31); break;
+    case Srl: result = ua >> (b & 31); break;
+    case Sra: result = a >> (b & 31); break;
+    case Mul: result = ua * ub; break;
+    case Div: case Divu: case Rem: case Remu:
+      if (b == 0) {
+        Exception(9);
+        write = false;
+      } else if (in.op == Divu) result = ua / ub;
+      else if (in.op == Remu) result = ua % ub;
+      else if (a == INT_MIN && b == -1) result = in.op == Div ? INT_MIN : 0;
+      else result = in.op == Div ? a / b : a % b;
+      break;
+    case Move: result = a; break;
+    case Neg: result = 0 - ua; break;
+    case Not: result = ~a; break;
+    case Li: result = in.imm; break;
+    case Lui: result = (unsigned)in.imm << 16; break;
+    case Lw: write = Load(a + in.imm, 4, true, &result); break;
+    case Lh: write = Load(a + in.imm, 2, true, &result); break;
+    case Lhu: write = Load(a + in.imm, 2, false, &result); break;
+    case Lb: write = Load(a + in.imm, 1, true, &result); break;
+    case Lbu: write = Load(a + in.imm, 1, false, &result); break;
+    case Sw: Store(a + in.imm, 4, regs[in.rd]); write = false; break;
+    case Sh: Store(a + in.imm, 2, regs[in.rd]); write = false; break;
+    case Sb: Store(a + in.imm, 1, regs[in.rd]); write = false; break;
+    case Beq: taken = a == b; break;
+    case Bne: taken = a != b; break;
+    case Blt: taken = a < b; break;
+    case Ble: taken = a <= b; break;
+    case Bgt: taken = a > b; break;
+    case Bge: taken = a >= b; break;
+    case Bltu: taken = ua < ub; break;
+    case Bleu: taken = ua <= ub; break;
+    case Bgtu: taken = ua > ub; break;
+    case Bgeu: taken = ua >= ub; break;
+    case Beqz: taken = a == 0; break;
+    case Bnez: taken = a != 0; break;
+    case Bltz: taken = a < 0; break;
+    case Blez: taken = a <= 0; break;
+    case Bgtz: taken = a > 0; break;
+    case Bgez: taken = a >= 0; break;
+    case J: next = in.target; break;
+    case Jal:
+      regs[RA] = TextBase + 4 * (pc + 1);
+      next = in.target;
+      write = false;
+      break;
+    case Jr: case Jalr:
+      result = TextBase + 4 * (pc + 1);
+      write = in.op == Jalr;
+      if (ua < TextBase || ua % 4 != 0 || (ua - TextBase) / 4 >= text.size()) {
+        Exception(6);
+        halted = true;
+      } else next = (ua - TextBase) / 4;
+      break;
+    case Syscall: DoSyscall(); write = false; break;
+    case Break: Exception(9); write = false; break;
+    default: write = false; break;
+  }
+  if (ClassOf(in.op) == BranchClass) {
+    write = false;
+    if (taken) {
+      branchesTaken++;
+      next = in.target;
+    }
+  }
+  if (in.op == J) write = false;
+  if (write && in.rd != 0) regs[in.rd] = result;
+  pc = next;
+}
+
+int MipsSimulator::Run()
+{
+  Assemble();
+  if (labels.count("_HeapNext")) heapNext = labels["_HeapNext"];
+  regs[GP] = GlobalPointer;
+  regs[SP] = StackTop - 4;
+  pc = 0;
+  while (!halted) {
+    if (pc < 0 || pc >= (int)text.size()) {
+      Exception(6);
+      break;
+    }
+    Step(text[pc]);
+  }
+  fflush(stdout);
+  return exitCode;
+}
+
+void MipsSimulator::PrintStats(FILE *out)
+{
+  fprintf(out, "%lld instructions: %lld alu, %lld mul/div, %lld loads, %lld stores, "
+          "%lld branches (%lld taken), %lld jumps, %lld calls, %lld syscalls\n",
+          numInstrs, classCounts[Alu], classCounts[MulDiv], classCounts[LoadClass],
+          classCounts[StoreClass], classCounts[BranchClass], branchesTaken,
+          classCounts[JumpClass], classCounts[CallClass], classCounts[SyscallClass]);
+  fprintf(out, "%lld heap bytes allocated, %lld from sbrk\n", heapBytes, sbrkBytes);
+}
@@ -0,0 +1,132 @@
+/* File: mipssim.h
+ * ---------------
+ * The MipsSimulator class assembles and runs the MIPS assembly that
+ * dcc emits, with defs.asm appended, so programs can be run on hosts
+ * without spim, and counts what they do while they run.
+ *
+ * The assembler takes the subset of SPIM's syntax that Mips and
+ * defs.asm use: the .text, .data, .globl, .align, .word, .byte,
+ * .space, .ascii and .asciiz directives, labels (alone or before a
+ * statement) and the real and pseudo instructions for integer
+ * arithmetic, compares, shifts, loads and stores, branches, jumps and
+ * syscall. Operands may be separated by commas or spaces, as in
+ * trap.handler, whose kernel sections are skipped.
+ *
+ * Memory is laid out as in SPIM: text from 0x00400000, the global area
+ * around $gp = 0x10008000, data from 0x10010000 with the heap (grown
+ * by sbrk) right after it, and the stack growing down from 0x80000000.
+ * Execution starts with trap.handler's startup code, which calls main
+ * and exits when it returns. The syscalls are those of SPIM used here:
+ * print_int, print_string, read_int, read_string, sbrk, exit,
+ * print_char, read_char and exit2.
+ *
+ * An exception is reported the way trap.handler reports it. Like
+ * trap.handler, the simulator ignores it and goes on with the next
+ * instruction, except for a jump out of the text, after which there is
+ * nothing sensible to go on with, so it stops.
+ *
+ * The counts are of instructions as written: a pseudo instruction, such
+ * as blt or li of a large constant, counts once, though SPIM would run
+ * two or three real ones for it.
+ *
+ * The heap bytes allocated are those objects take, headers included,
+ * counted as _HeapNext moves up past them, whether _Alloc or a new site
+ * bumps it. _HeapNext only ever goes to a new run from 0, where
+ * _RetireRun leaves it, so only a rise from a nonzero value is counted.
+ * The bytes from sbrk, which the heap grows by in chunks, are counted
+ * apart.
+ */
+
+#ifndef _H_mipssim
+#define _H_mipssim
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+class MipsSimulator {
+  public:
+    typedef enum { Alu, MulDiv, LoadClass, StoreClass, BranchClass, JumpClass,
+                   CallClass, SyscallClass, NumClasses } InstrClass;
+
+  private:
+    typedef enum {
+      Add, Addu, Sub, Subu, And, Or, Xor, Nor, Slt, Sltu, Seq, Sne, Sge, Sgeu,
+      Sgt, Sgtu, Sle, Sleu, Sll, Srl, Sra, Mul, Div, Divu, Rem, Remu,
+      Move, Neg, Not, Li, Lui,
+      Lw, Lb, Lbu, Lh, Lhu, Sw, Sb, Sh,
+      Beq, Bne, Blt, Ble, Bgt, Bge, Bltu, Bleu, Bgtu, Bgeu,
+      Beqz, Bnez, Bltz, Blez, Bgtz, Bgez,
+      J, Jal, Jr, Jalr, Syscall, Nop, Break,
+      NumOpcodes
+    } Opcode;
+
+    struct Instr {
+      Opcode op;
+      int rd, rs, rt;                   // rt unused when useImm
+      bool useImm;
+      int imm;                          // constant, offset or address
+      int target;                       // index of the branch target
+      int line;                         // into lines, for errors
+    };
+    struct Line {
+      std::string text, file;
+      int number;
+    };
+    struct Statement {                  // a text line, until decoded
+      std::string mnemonic;
+      std::vector<std::string> operands;
+      int line;
+    };
+
+    std::vector<Line> lines;
+    std::vector<Statement> statements;
+    std::vector<Instr> text;
+    std::map<std::string, int> labels;  // -> address
+    std::vector<std::pair<int, std::string> > wordFixups;  // data offset, label
+    std::vector<unsigned char> data, stack;
+    int brk;                            // end of the heap
+
+    int regs[32];
+    int pc;                             // index into text
+    bool halted;
+    int exitCode;
+
+    long long numInstrs, classCounts[NumClasses];
+    long long branchesTaken, heapBytes, sbrkBytes;
+    unsigned heapNext;                  // address of _HeapNext, or 0
+
+    void Error(int line, const char *format, ...);
+    void Assemble();
+    void Directive(const std::string &name, const std::string &rest, int line);
+    void Decode(const Statement &s);
+    int Register(const std::string &operand, int line);
+    bool IsRegister(const std::string &operand);
+    int Value(const std::string &operand, int line);
+    void Address(const std::string &operand, Instr *instr, int line);
+    int Target(const std::string &operand, int line);
+    static InstrClass ClassOf(Opcode op);
+
+    unsigned char *Translate(unsigned addr, int bytes);
+    void Exception(int code);
+    bool Load(unsigned addr, int bytes, bool isSigned, int *value);
+    bool Store(unsigned addr, int bytes, int value);
+    void DoSyscall();
+    void Step(const Instr &in);
+
+  public:
+    MipsSimulator();
+
+         // Adds the assembly in file to the program; false if it can't
+         // be read
+    bool LoadFile(const char *file);
+
+         // Assembles the program and runs it; returns its exit code
+    int Run();
+
+         // Prints the counts of what the run did
+    void PrintStats(FILE *out);
+};
+
+#endif
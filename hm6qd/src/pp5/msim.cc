@@ -0,0 +1,38 @@
+/* File: msim.cc
+ * -------------
+ * The main() of msim, which runs MIPS assembly in a MipsSimulator:
+ *
+ *     msim [-s] file.asm ...
+ *
+ * The files are assembled together, as if concatenated, so a program
+ * from dcc is run as "msim tmp.asm defs.asm". With -s, the counts of
+ * what it ran are printed to stderr when it finishes.
+ */
+
+#include "mipssim.h"
+#include <cstdio>
+#include <cstring>
+
+int main(int argc, char *argv[])
+{
+  MipsSimulator sim;
+  bool stats = false;
+  int i = 1;
+  if (i < argc && strcmp(argv[i], "-s") == 0) {
+    stats = true;
+    i++;
+  }
+  if (i == argc) {
+    fprintf(stderr, "Usage: msim [-s] file.asm ...\n");
+    return 2;
+  }
+  for (; i < argc; i++) {
+    if (!sim.LoadFile(argv[i])) {
+      fprintf(stderr, "msim: cannot read %s\n", argv[i]);
+      return 2;
+    }
+  }
+  int exitCode = sim.Run();
+  if (stats) sim.PrintStats(stderr);
+  return exitCode;
+}
@@ -0,0 +1,99 @@
+/* File: parser.y
+ * --------------
+ * Yacc input file to generate the parser for the compiler.
+ *
+ * pp5: add parser rules and tree construction from your past projects. 
+ *      You should not need to make any significant changes in the parser itself. 
+ *      After parsing completes, if no errors were found, the parser calls
+ *      program->Emit() to kick off the code generation pass. The
+ *      interesting work happens during the tree traversal.
+ */
+
+%{
+
+#include "scanner.h" // for yylex
+#include "parser.h"
+#include "errors.h"
+
+void yyerror(const char *msg); // standard error-handling routine
+
+%}
+
+ 
+/* yylval 
+ * ------
+ */
+%union {
+    int integerConstant;
+    bool boolConstant;
+    char *stringConstant;
+    double doubleConstant;
+    char identifier[MaxIdentLen+1]; // +1 for terminating null
+    Decl *decl;
+    List<Decl*> *declList;
+}
+
+
+/* Tokens
+ * ------
+ */
+%token   T_Void T_Bool T_Int T_Double T_String T_Class 
+%token   T_LessEqual T_GreaterEqual T_Equal T_NotEqual T_Dims
+%token   T_And T_Or T_Null T_Extends T_This T_Interface T_Implements
+%token   T_While T_For T_If T_Else T_Return T_Break
+%token   T_New T_NewArray T_Print T_ReadInteger T_ReadLine
+
+%token   <identifier> T_Identifier
+%token   <stringConstant> T_StringConstant 
+%token   <integerConstant> T_IntConstant
+%token   <doubleConstant> T_DoubleConstant
+%token   <boolConstant> T_BoolConstant
+
+
+/* Non-terminal types
+ * ------------------
+ */
+%type <declList>  DeclList 
+
+%%
+/* Rules
+ * -----
+	 
+ */
+Program   :    DeclList            { 
+                                      @1; 
+                                      Program *program = new Program($1);
+                                      // if no errors, advance to next phase
+                                      if (ReportError::NumErrors() == 0) 
+                                          program->Check(); 
+                                      if (ReportError::NumErrors() == 0) 
+                                          program->Emit();
+                                    }
+          ;
+
+DeclList  :            { /* replace with your parser */ }
+          ;
+
+
+
+%%
+
+
+/* Function: InitParser
+ * --------------------
+ * This function will be called before any calls to yyparse().  It is designed
+ * to give you an opportunity to do anything that must be done to initialize
+ * the parser (set global variables, configure starting state, etc.). One
+ * thing it already does for you is assign the value of the global variable
+ * yydebug that controls whether yacc prints debugging information about
+ * parser actions (shift/reduce) and contents of state stack during parser.
+ * If set to false, no information is printed. Setting it to true will give
+ * you a running trail that might be helpful when debugging your parser.
+ * Please be sure the variable is set to false when submitting your final
+ * version.
+ */
+void InitParser()
+{
+   PrintDebug("parser", "Initializing parser");
+   yydebug = false;
+}
@@ -0,0 +1,45 @@
+# counts.asm: a check of msim's counters, which runs alone as
+#     msim -s samples/counts.asm 2>&1
+# and should print counts.out. With the startup code's jal main, li and
+# syscall, it runs 34 instructions: 15 alu, 1 mul/div, 2 loads, 5
+# stores, 2 branches (1 taken), 3 jumps, 2 calls and 4 syscalls.
+# _HeapNext goes to two runs from 0, which allocates nothing, and moves
+# up 12 bytes twice between, so 24 heap bytes are allocated, 64 from sbrk.
+	.text
+	.globl main
+main:
+	move $s0, $ra
+	li $v0, 9
+	li $a0, 64
+	syscall               # sbrk 64
+	addiu $t0, $v0, 4
+	sw $t0, _HeapNext     # a run from 0
+	li $t3, 2
+_Bump:
+	lw $t0, _HeapNext
+	addiu $t0, $t0, 12
+	sw $t0, _HeapNext     # 12 bytes allocated
+	addiu $t3, $t3, -1
+	bnez $t3, _Bump       # taken the first time only
+	sw $zero, _HeapNext   # retired
+	sw $v0, _HeapNext     # another run from 0
+	jal _Square
+	li $v0, 1
+	syscall               # prints 9
+	li $v0, 11
+	li $a0, 10
+	syscall               # and a newline
+	j _Done
+	li $a0, 99            # jumped over
+_Done:
+	move $ra, $s0
+	jr $ra
+
+_Square:
+	li $t1, 3
+	mul $a0, $t1, $t1
+	jr $ra
+
+	.data
+	.align 2
+_HeapNext: .word 0
@@ -0,0 +1,267 @@
+/* File: sccp.cc
+ * -------------
+ * Implementation of the ConstantPropagation class.
+ */
+
+#include "sccp.h"
+#include "cfg.h"
+#include <climits>
+#include <cstring>
+
+
+ConstantPropagation::ConstantPropagation(FlowGraph *g) : cfg(g)
+{
+  NumberVariables();
+  Solve();
+}
+
+void ConstantPropagation::NumberVariables()
+{
+  Location *srcs[Instruction::MaxSources + 1];
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    std::vector<Instruction*> &code = cfg->GetBlock(b)->code;
+    for (int i = 0; i < code.size(); i++) {
+      Location *dst = code[i]->GetDst();
+      int n = code[i]->GetSources(srcs);
+      if (dst) srcs[n++] = dst;
+      for (int j = 0; j < n; j++)
+        if (srcs[j]->GetSegment() == fpRelative && !varIndex.count(srcs[j])) {
+          int index = varIndex.size();
+          varIndex[srcs[j]] = index;
+        }
+    }
+  }
+}
+
+ConstantPropagation::Value ConstantPropagation::Lookup(Location *var, const State &s)
+{
+  std::map<Location*, int>::iterator it = varIndex.find(var);
+  if (it == varIndex.end()) {
+    Value v = {Varying, 0};             // globals can change behind our back
+    return v;
+  }
+  return s[it->second];
+}
+
+/* Method: Fold
+ * ------------
+ * Computes a op b the way the MIPS instruction chosen for op would.
+ * Division and remainder by zero, the one overflowing division, and
+ * sums, differences and products that overflow are left for run time,
+ * where add and sub trap.
+ */
+bool ConstantPropagation::Fold(BinaryOp::OpCode code, int a, int b, int *result)
+{
+  unsigned int ua = a, ub = b;
+  long long wide;
+  switch (code) {
+    case BinaryOp::Add:
+    case BinaryOp::Sub:
+    case BinaryOp::Mul:
+      wide = code == BinaryOp::Add ? (long long)a + b
+           : code == BinaryOp::Sub ? (long long)a - b : (long long)a * b;
+      if (wide != (int)wide) return false;
+      *result = (int)wide;
+      return true;
+    case BinaryOp::Div:
+    case BinaryOp::Mod:
+      if (b == 0 || (a == INT_MIN && b == -1)) return false;
+      *result = code == BinaryOp::Div ? a / b : a % b;
+      return true;
+    case BinaryOp::Eq:   *result = a == b; return true;
+    case BinaryOp::Less: *result = a < b; return true;
+    case BinaryOp::And:  *result = a & b; return true;
+    case BinaryOp::Or:   *result = a | b; return true;
+    case BinaryOp::NotEq:     *result = a != b; return true;
+    case BinaryOp::LessEq:    *result = a <= b; return true;
+    case BinaryOp::Greater:   *result = a > b; return true;
+    case BinaryOp::GreaterEq: *result = a >= b; return true;
+    case BinaryOp::UnsignedGreaterEq: *result = ua >= ub; return true;
+    case BinaryOp::UnsignedSub:       *result = (int)(ua - ub); return true;
+    default:             return false;
+  }
+}
+
+/* Method: Evaluate
+ * ----------------
+ * Returns the lattice value instr assigns to its destination, given the
+ * values of its operands in s.
+ */
+ConstantPropagation::Value ConstantPropagation::Evaluate(Instruction *instr, const State &s)
+{
+  Value result = {Varying, 0};
+  LoadConstant *lc = dynamic_cast<LoadConstant*>(instr);
+  BinaryOp *op = dynamic_cast<BinaryOp*>(instr);
+  Location *srcs[Instruction::MaxSources];
+
+  if (lc) {
+    result.level = Constant;
+    result.val = lc->value();
+  } else if (dynamic_cast<Assign*>(instr)) {
+    instr->GetSources(srcs);
+    result = Lookup(srcs[0], s);
+  } else if (op) {
+    op->GetSources(srcs);
+    Value a = Lookup(srcs[0], s), b = Lookup(srcs[1], s);
+    if (a.level == Varying || b.level == Varying)
+      result.level = Varying;
+    else if (a.level == Undefined || b.level == Undefined)
+      result.level = Undefined;
+    else if (Fold(op->opcode(), a.val, b.val, &result.val))
+      result.level = Constant;
+  }
+  return result;
+}
+
+void ConstantPropagation::Transfer(Instruction *instr, State &s)
+{
+  Location *dst = instr->GetDst();
+  if (dst && varIndex.count(dst))
+    s[varIndex[dst]] = Evaluate(instr, s);
+}
+
+/* Method: EvaluateBranch
+ * ----------------------
+ * Returns whether the branch jumps: constant 1 if it certainly does,
+ * constant 0 if it certainly falls through.
+ */
+ConstantPropagation::Value ConstantPropagation::EvaluateBranch(CondBranch *branch, const State &s)
+{
+  Location *srcs[Instruction::MaxSources];
+  int n = branch->GetSources(srcs);
+  Value a = Lookup(srcs[0], s), result = a;
+  IfCmp *cmp = dynamic_cast<IfCmp*>(branch);
+  if (!cmp) {
+    result.val = a.val == 0;              // IfZ jumps on zero
+    return result;
+  }
+  Assert(n == 2);
+  Value b = Lookup(srcs[1], s);
+  if (a.level == Varying || b.level == Varying)
+    result.level = Varying;
+  else if (a.level == Undefined || b.level == Undefined)
+    result.level = Undefined;
+  else
+    Fold(cmp->opcode(), a.val, b.val, &result.val);
+  return result;
+}
+
+/* Method: TakesBranch
+ * -------------------
+ * Is the edge from -> to executable when from is left in state s? Only
+ * a conditional branch can rule out one of its edges: it takes neither
+ * while its test is still undefined, and just one once it is known.
+ */
+bool ConstantPropagation::TakesBranch(BasicBlock *from, BasicBlock *to, const State &s)
+{
+  CondBranch *branch = dynamic_cast<CondBranch*>(from->GetLast());
+  if (!branch) return true;
+  Value jumps = EvaluateBranch(branch, s);
+  if (jumps.level == Varying) return true;
+  if (jumps.level == Undefined) return false;
+  bool isTarget = to->GetLabel() && !strcmp(to->GetLabel(), branch->branch_label());
+  bool isNext = from->id + 1 < cfg->NumBlocks() && cfg->GetBlock(from->id + 1) == to;
+  return jumps.val ? isTarget : isNext;
+}
+
+/* Method: Propagate
+ * -----------------
+ * Marks the edge into to as executable by merging s into its entry
+ * state, and queues to if that changed anything.
+ */
+void ConstantPropagation::Propagate(BasicBlock *to, const State &s)
+{
+  bool changed = !executable[to->id];
+  executable[to->id] = true;
+  State &dst = in[to->id];
+  for (int v = 0; v < s.size(); v++) {
+    Value merged = dst[v];
+    if (s[v].level == Undefined || merged.level == Varying)
+      continue;
+    if (merged.level == Undefined)
+      merged = s[v];
+    else if (s[v].level == Varying || s[v].val != merged.val)
+      merged.level = Varying;
+    if (merged.level != dst[v].level || merged.val != dst[v].val) {
+      dst[v] = merged;
+      changed = true;
+    }
+  }
+  if (changed)
+    worklist.push_back(to);
+}
+
+/* Method: Solve
+ * -------------
+ * Iterates to a fixed point from the entry block. Everything is Varying
+ * on entry: params come from the caller, and reading a local before
+ * assigning it must not be mistaken for a constant.
+ */
+void ConstantPropagation::Solve()
+{
+  Value undefined = {Undefined, 0}, varying = {Varying, 0};
+  in.assign(cfg->NumBlocks(), State(varIndex.size(), undefined));
+  executable.assign(cfg->NumBlocks(), false);
+
+  Propagate(cfg->GetEntry(), State(varIndex.size(), varying));
+  while (!worklist.empty()) {
+    BasicBlock *b = worklist.back();
+    worklist.pop_back();
+    State s = in[b->id];
+    for (int i = 0; i < b->code.size(); i++)
+      Transfer(b->code[i], s);
+    for (int i = 0; i < b->succs.size(); i++)
+      if (TakesBranch(b, b->succs[i], s))
+        Propagate(b->succs[i], s);
+  }
+}
+
+void ConstantPropagation::Rewrite(std::vector<Instruction*> &fn)
+{
+  int folded = 0, branches = 0, deleted = 0;
+  std::vector<Instruction*> out;
+
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *block = cfg->GetBlock(b);
+    if (!executable[b]) {
+      deleted++;
+      if (dynamic_cast<EndFunc*>(block->GetLast()))
+        out.push_back(block->GetLast());   // every function keeps its end
+      continue;
+    }
+    State s = in[b];
+    for (int i = 0; i < block->code.size(); i++) {
+      Instruction *instr = block->code[i];
+      Location *dst = instr->GetDst();
+      CondBranch *branch = dynamic_cast<CondBranch*>(instr);
+      if ((dynamic_cast<Assign*>(instr) || dynamic_cast<BinaryOp*>(instr))
+          && varIndex.count(dst)) {
+        Value v = Evaluate(instr, s);
+        if (v.level == Constant) {
+          instr = new LoadConstant(dst, v.val);
+          folded++;
+        }
+      } else if (branch) {
+        Value jumps = EvaluateBranch(branch, s);
+        if (jumps.level == Constant) {
+          instr = jumps.val ? new Goto(branch->branch_label()) : NULL;
+          branches++;
+        }
+      }
+      Transfer(block->code[i], s);
+      if (instr) out.push_back(instr);
+    }
+  }
+
+  // A branch may now jump to the label right after it
+  fn.clear();
+  for (int i = 0; i < out.size(); i++) {
+    Goto *g = dynamic_cast<Goto*>(out[i]);
+    Label *next = i + 1 < out.size() ? dynamic_cast<Label*>(out[i+1]) : NULL;
+    if (g && next && !strcmp(g->branch_label(), next->text()))
+      continue;
+    fn.push_back(out[i]);
+  }
+  PrintDebug("sccp", "%d folded, %d branches resolved, %d blocks deleted",
+             folded, branches, deleted);
+}
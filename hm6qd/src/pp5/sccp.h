@@ -0,0 +1,67 @@
+/* File: sccp.h
+ * ------------
+ * The ConstantPropagation class implements sparse conditional constant
+ * propagation (Wegman & Zadeck) over the FlowGraph of one function.
+ *
+ * Each fp-relative variable is mapped to a lattice value at the entry
+ * of each block: Undefined (no executable path has reached it yet), a
+ * Constant, or Varying. Blocks are only visited once some executable
+ * edge reaches them, and an IfZ whose test is a known constant makes
+ * only one of its out edges executable, so constants flowing around a
+ * branch that is never taken are not spoiled by it. The same goes for
+ * an IfCmp whose operands are both known.
+ *
+ * Since the TAC is not in SSA form, values are tracked per block
+ * rather than per definition, in the style of the "conditional
+ * constant" data-flow formulation of the same paper.
+ *
+ * Rewriting then replaces each Assign/BinaryOp whose result is a
+ * known constant with a LoadConstant, turns a conditional branch on
+ * constants into a Goto or drops it, and deletes the blocks that were
+ * never reached.
+ */
+
+#ifndef _H_sccp
+#define _H_sccp
+
+#include <map>
+#include <vector>
+#include "tac.h"
+class FlowGraph;
+class BasicBlock;
+
+class ConstantPropagation {
+  private:
+    typedef enum { Undefined, Constant, Varying } Level;
+    struct Value {
+      Level level;
+      int val;
+    };
+    typedef std::vector<Value> State;
+
+    FlowGraph *cfg;
+    std::map<Location*, int> varIndex;
+    std::vector<State> in;              // per block, at block entry
+    std::vector<bool> executable;       // per block
+    std::vector<BasicBlock*> worklist;
+
+    void NumberVariables();
+    void Solve();
+    void Propagate(BasicBlock *to, const State &s);
+    Value Lookup(Location *var, const State &s);
+    Value Evaluate(Instruction *instr, const State &s);
+    void Transfer(Instruction *instr, State &s);
+    Value EvaluateBranch(CondBranch *branch, const State &s);
+    bool TakesBranch(BasicBlock *from, BasicBlock *to, const State &s);
+
+  public:
+    ConstantPropagation(FlowGraph *cfg);
+
+         // Computes a op b into result, false if that is left to run time
+    static bool Fold(BinaryOp::OpCode code, int a, int b, int *result);
+
+         // Writes the function's rewritten instructions to fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
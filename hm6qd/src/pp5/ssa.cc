@@ -0,0 +1,390 @@
+/* File: ssa.cc
+ * ------------
+ * Implementation of the SSAForm class.
+ */
+
+#include "ssa.h"
+#include "cfg.h"
+#include "codegen.h"
+#include "liveness.h"
+#include <cstring>
+
+
+SSAForm::SSAForm(FlowGraph *g, CodeGenerator *c)
+  : cfg(g), cg(c), numPhis(0), numCoalesced(0)
+{
+  ComputeFrontiers();
+  ChooseVariables();
+  PlacePhis();
+  stacks.assign(vars.size(), std::vector<Location*>());
+  numVersions.assign(vars.size(), 0);
+  Rename(cfg->GetEntry());
+  Print();
+}
+
+bool SSAForm::IsTracked(Location *var)
+{
+  return var && var->GetSegment() == fpRelative;
+}
+
+/* Method: ComputeFrontiers
+ * ------------------------
+ * The dominance frontier of a block is where its dominance ends: the
+ * blocks it does not strictly dominate that have a predecessor it does
+ * dominate. Found as in Cooper, Harvey and Kennedy, by walking up the
+ * dominator tree from each predecessor of a join point to its idom.
+ */
+void SSAForm::ComputeFrontiers()
+{
+  frontier.assign(cfg->NumBlocks(), std::set<BasicBlock*>());
+  children.assign(cfg->NumBlocks(), std::vector<BasicBlock*>());
+  const std::vector<BasicBlock*> &rpo = cfg->GetReversePostorder();
+  for (int i = 0; i < rpo.size(); i++) {
+    BasicBlock *b = rpo[i];
+    if (b->idom) children[b->idom->id].push_back(b);
+    if (b->preds.size() < 2) continue;
+    for (int p = 0; p < b->preds.size(); p++)
+      for (BasicBlock *r = b->preds[p]; r && r->reachable && r != b->idom; r = r->idom)
+        frontier[r->id].insert(b);
+  }
+}
+
+/* Method: ChooseVariables
+ * -----------------------
+ * A variable needs renaming if it is written more than once, or is a
+ * param written at all (its value on entry is a definition too).
+ */
+void SSAForm::ChooseVariables()
+{
+  std::map<Location*, int> defs;
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    std::vector<Instruction*> &code = cfg->GetBlock(b)->code;
+    for (int i = 0; i < code.size(); i++) {
+      Location *dst = code[i]->GetDst();
+      if (IsTracked(dst) && defs[dst]++ == (dst->GetOffset() >= 0 ? 0 : 1)) {
+        varIndex[dst] = vars.size();
+        vars.push_back(dst);
+      }
+    }
+  }
+}
+
+/* Method: ComputeLiveIn
+ * ---------------------
+ * Which of the variables being renamed are live on entry to each
+ * block, so Phis are only placed where their value is wanted.
+ */
+void SSAForm::ComputeLiveIn(std::vector<std::vector<bool> > &liveIn)
+{
+  int n = cfg->NumBlocks();
+  std::vector<std::vector<bool> > use(n, std::vector<bool>(vars.size(), false));
+  std::vector<std::vector<bool> > def = use;
+  Location *srcs[Instruction::MaxSources];
+  for (int b = 0; b < n; b++) {
+    std::vector<Instruction*> &code = cfg->GetBlock(b)->code;
+    for (int i = 0; i < code.size(); i++) {
+      int numSrcs = code[i]->GetSources(srcs);
+      for (int j = 0; j < numSrcs; j++)
+        if (varIndex.count(srcs[j]) && !def[b][varIndex[srcs[j]]])
+          use[b][varIndex[srcs[j]]] = true;
+      Location *dst = code[i]->GetDst();
+      if (varIndex.count(dst)) def[b][varIndex[dst]] = true;
+    }
+  }
+  liveIn = use;
+  const std::vector<BasicBlock*> &rpo = cfg->GetReversePostorder();
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = rpo.size() - 1; i >= 0; i--) {
+      BasicBlock *b = rpo[i];
+      for (int s = 0; s < b->succs.size(); s++) {
+        std::vector<bool> &out = liveIn[b->succs[s]->id];
+        for (int v = 0; v < vars.size(); v++)
+          if (out[v] && !def[b->id][v] && !liveIn[b->id][v]) {
+            liveIn[b->id][v] = true;
+            changed = true;
+          }
+      }
+    }
+  }
+}
+
+static int StartOfBody(BasicBlock *b)
+{
+  int i = 0;
+  if (i < b->code.size() && dynamic_cast<Label*>(b->code[i])) i++;
+  while (i < b->code.size() && dynamic_cast<Phi*>(b->code[i])) i++;
+  return i;
+}
+
+/* Method: PlacePhis
+ * -----------------
+ * Each variable gets a Phi in the iterated dominance frontier of the
+ * blocks that write it, wherever it is live on entry.
+ */
+void SSAForm::PlacePhis()
+{
+  std::vector<std::vector<bool> > liveIn;
+  ComputeLiveIn(liveIn);
+  for (int v = 0; v < vars.size(); v++) {
+    std::vector<bool> hasPhi(cfg->NumBlocks(), false), queued = hasPhi;
+    std::vector<BasicBlock*> worklist;
+    for (int b = 0; b < cfg->NumBlocks(); b++) {
+      BasicBlock *block = cfg->GetBlock(b);
+      for (int i = 0; i < block->code.size() && block->reachable; i++)
+        if (block->code[i]->GetDst() == vars[v] && !queued[b]) {
+          queued[b] = true;
+          worklist.push_back(block);
+        }
+    }
+    while (!worklist.empty()) {
+      BasicBlock *b = worklist.back();
+      worklist.pop_back();
+      std::set<BasicBlock*>::iterator it;
+      for (it = frontier[b->id].begin(); it != frontier[b->id].end(); ++it) {
+        BasicBlock *f = *it;
+        if (hasPhi[f->id] || !liveIn[f->id][v]) continue;
+        Phi *phi = new Phi(vars[v], f->preds.size());
+        f->code.insert(f->code.begin() + StartOfBody(f), phi);
+        phiVar[phi] = v;
+        hasPhi[f->id] = true;
+        numPhis++;
+        if (!queued[f->id]) {
+          queued[f->id] = true;
+          worklist.push_back(f);
+        }
+      }
+    }
+  }
+}
+
+Location *SSAForm::NewVersion(int v)
+{
+  Location *var = vars[v];
+  int n = numVersions[v]++;
+  if (n == 0 && var->GetOffset() < 0)
+    return var;
+  char name[128];
+  sprintf(name, "%.100s.%d", var->GetName(), n + 1);
+  return new Location(fpRelative, CodeGenerator::OffsetToFirstLocal, name);
+}
+
+/* Method: Current
+ * ---------------
+ * The version of var that reaches the current point of the renaming
+ * walk. With none on the stack it is the value on entry, which is the
+ * original Location (for a local, an uninitialized read).
+ */
+Location *SSAForm::Current(Location *var)
+{
+  std::map<Location*, int>::iterator it = varIndex.find(var);
+  if (it == varIndex.end() || stacks[it->second].empty())
+    return var;
+  return stacks[it->second].back();
+}
+
+/* Method: Rename
+ * --------------
+ * Renames the uses and definitions in b, fills in the arguments of the
+ * Phis of its successors for the edges from b, and recurses down the
+ * dominator tree, popping the versions b pushed on the way out.
+ */
+void SSAForm::Rename(BasicBlock *b)
+{
+  std::vector<int> pushed;
+  Location *srcs[Instruction::MaxSources];
+  for (int i = 0; i < b->code.size(); i++) {
+    Instruction *instr = b->code[i];
+    Phi *phi = dynamic_cast<Phi*>(instr);
+    if (!phi) {
+      int n = instr->GetSources(srcs);
+      bool renamed = false;
+      for (int j = 0; j < n; j++) {
+        Location *cur = Current(srcs[j]);
+        renamed = renamed || cur != srcs[j];
+        srcs[j] = cur;
+      }
+      if (renamed) instr->SetSources(srcs);
+    }
+    Location *dst = instr->GetDst();
+    if (dst && varIndex.count(dst)) {
+      int v = phi ? phiVar[phi] : varIndex[dst];
+      Location *version = NewVersion(v);
+      if (version != dst) instr->SetDst(version);
+      stacks[v].push_back(version);
+      pushed.push_back(v);
+    }
+  }
+  for (int s = 0; s < b->succs.size(); s++) {
+    BasicBlock *succ = b->succs[s];
+    int p = 0;
+    while (succ->preds[p] != b) p++;
+    for (int i = 0; i < succ->code.size(); i++) {
+      Phi *phi = dynamic_cast<Phi*>(succ->code[i]);
+      if (phi) phi->SetArg(p, Current(vars[phiVar[phi]]));
+    }
+  }
+  for (int c = 0; c < children[b->id].size(); c++)
+    Rename(children[b->id][c]);
+  for (int i = 0; i < pushed.size(); i++)
+    stacks[pushed[i]].pop_back();
+}
+
+void SSAForm::Print()
+{
+  if (!IsDebugOn("ssa")) return;
+  PrintDebug("ssa", "%d variables renamed, %d phis placed", (int)vars.size(), numPhis);
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    PrintDebug("ssa", "B%d", b);
+    std::vector<Instruction*> &code = cfg->GetBlock(b)->code;
+    for (int i = 0; i < code.size(); i++)
+      code[i]->Print();
+  }
+}
+
+static void InsertAtEnd(BasicBlock *b, Instruction *instr)
+{
+  Instruction *last = b->GetLast();
+  if (last && (dynamic_cast<Goto*>(last) || dynamic_cast<CondBranch*>(last) ||
+               dynamic_cast<JumpTable*>(last)))
+    b->code.insert(b->code.end() - 1, instr);
+  else
+    b->code.push_back(instr);
+}
+
+/* Method: IsolatePhis
+ * -------------------
+ * Replaces each "x = phi(a, b)" by a fresh temp t, with "t = a" and
+ * "t = b" at the end of the predecessors and "x = t" where the Phi
+ * was. t is live only across the edges into the block, so the copies
+ * are right whatever else is live there, even on an edge out of a
+ * block with two successors.
+ */
+void SSAForm::IsolatePhis()
+{
+  std::map<BasicBlock*, std::vector<Instruction*> > atEnd;
+  for (int b = 0; b < cfg->NumBlocks(); b++) {
+    BasicBlock *block = cfg->GetBlock(b);
+    std::vector<Instruction*> copies, rest;
+    for (int i = 0; i < block->code.size(); i++) {
+      Phi *phi = dynamic_cast<Phi*>(block->code[i]);
+      if (!phi) {
+        rest.push_back(block->code[i]);
+        continue;
+      }
+      Location *t = cg->GenTempVar();
+      for (int p = 0; p < phi->NumArgs(); p++)
+        if (block->preds[p]->reachable)
+          atEnd[block->preds[p]].push_back(new Assign(t, phi->GetArg(p)));
+      copies.push_back(new Assign(phi->GetDst(), t));
+      delete phi;
+    }
+    int start = (!rest.empty() && dynamic_cast<Label*>(rest[0])) ? 1 : 0;
+    rest.insert(rest.begin() + start, copies.begin(), copies.end());
+    block->code = rest;
+  }
+  std::map<BasicBlock*, std::vector<Instruction*> >::iterator it;
+  for (it = atEnd.begin(); it != atEnd.end(); ++it)
+    for (int i = 0; i < it->second.size(); i++)
+      InsertAtEnd(it->first, it->second[i]);
+}
+
+/* Method: Coalesce
+ * ----------------
+ * Chaitin-style coalescing of the copies in fn. A variable interferes
+ * with each variable live after an instruction that writes it, bar the
+ * source of a copy into it. A copy whose two sides do not interfere
+ * is removed by merging the two into one variable, which then
+ * interferes with what either did. Two params can't be merged, having
+ * slots of their own, and a class with a param in it keeps its name;
+ * otherwise a named variable wins over a temp.
+ */
+static int Rank(Location *var)
+{
+  if (var->GetOffset() >= 0) return 2;  // param
+  return var->GetName()[0] == '_' ? 0 : 1;
+}
+
+void SSAForm::Coalesce(std::vector<Instruction*> &fn)
+{
+  Liveness liveness(fn);
+  std::vector<Location*> all;
+  std::set<Location*> seen;
+  Location *srcs[Instruction::MaxSources + 1];
+  for (int i = 0; i < fn.size(); i++) {
+    Location *dst = fn[i]->GetDst();
+    int n = fn[i]->GetSources(srcs);
+    if (dst) srcs[n++] = dst;
+    for (int j = 0; j < n; j++)
+      if (IsTracked(srcs[j]) && seen.insert(srcs[j]).second)
+        all.push_back(srcs[j]);
+  }
+
+  std::map<Location*, std::set<Location*> > adj;
+  for (int i = 0; i < fn.size(); i++) {
+    Location *dst = fn[i]->GetDst();
+    if (!IsTracked(dst)) continue;
+    Location *copied = NULL;
+    if (dynamic_cast<Assign*>(fn[i]) && fn[i]->GetSources(srcs)) copied = srcs[0];
+    for (int v = 0; v < all.size(); v++)
+      if (all[v] != dst && all[v] != copied && liveness.IsLiveOut(i, all[v])) {
+        adj[dst].insert(all[v]);
+        adj[all[v]].insert(dst);
+      }
+  }
+
+  std::map<Location*, Location*> rep;
+  for (int v = 0; v < all.size(); v++)
+    rep[all[v]] = all[v];
+  for (int i = 0; i < fn.size(); i++) {
+    if (!dynamic_cast<Assign*>(fn[i])) continue;
+    fn[i]->GetSources(srcs);
+    Location *a = fn[i]->GetDst(), *b = srcs[0];
+    if (!IsTracked(a) || !IsTracked(b)) continue;
+    while (rep[a] != a) a = rep[a];
+    while (rep[b] != b) b = rep[b];
+    if (a == b || adj[a].count(b) || (Rank(a) == 2 && Rank(b) == 2))
+      continue;
+    if (Rank(b) > Rank(a)) std::swap(a, b);
+    rep[b] = a;                         // b is merged into a
+    std::set<Location*>::iterator it;
+    for (it = adj[b].begin(); it != adj[b].end(); ++it) {
+      adj[*it].erase(b);
+      adj[*it].insert(a);
+      adj[a].insert(*it);
+    }
+    adj.erase(b);
+  }
+
+  std::vector<Instruction*> code;
+  for (int i = 0; i < fn.size(); i++) {
+    Instruction *instr = fn[i];
+    int n = instr->GetSources(srcs);
+    bool renamed = false;
+    for (int j = 0; j < n; j++) {
+      Location *r = srcs[j];
+      if (IsTracked(r)) while (rep[r] != r) r = rep[r];
+      renamed = renamed || r != srcs[j];
+      srcs[j] = r;
+    }
+    if (renamed) instr->SetSources(srcs);
+    Location *dst = instr->GetDst(), *r = dst;
+    if (IsTracked(r)) while (rep[r] != r) r = rep[r];
+    if (r != dst) instr->SetDst(r);
+    if (dynamic_cast<Assign*>(instr) && n == 1 && srcs[0] == r) {
+      numCoalesced++;
+      continue;
+    }
+    code.push_back(instr);
+  }
+  fn = code;
+}
+
+void SSAForm::Destroy(std::vector<Instruction*> &fn)
+{
+  IsolatePhis();
+  cfg->Flatten(fn);
+  Coalesce(fn);
+  PrintDebug("ssa", "%d copies coalesced", numCoalesced);
+}
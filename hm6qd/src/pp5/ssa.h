@@ -0,0 +1,75 @@
+/* File: ssa.h
+ * -----------
+ * The SSAForm class puts the Tac of one function into static single
+ * assignment form, and takes it back out again once the passes that
+ * want it are done.
+ *
+ * Temps are written once already, but locals, params and the targets
+ * of assignments are not. Each of the fp-relative variables written
+ * more than once (or, for a param, at all) gets a new Location per
+ * definition, named after the variable ("i.2"), and a Phi is placed at
+ * the start of each block in the iterated dominance frontier of its
+ * definitions where it is live (the pruned form of Cytron et al.).
+ * The renaming walks the dominator tree, rewriting each use to the
+ * version that reaches it. The first definition of a local keeps the
+ * original Location, as does the entry value of a param.
+ *
+ * Leaving SSA follows Sreedhar's method I: each Phi gets a fresh temp,
+ * copied from the matching argument at the end of each predecessor and
+ * into the Phi's destination at the top of its block. That is correct
+ * even after other passes have made the versions of a variable
+ * overlap. The copies, along with those the code generator made, are
+ * then coalesced wherever source and destination do not interfere, so
+ * what is left is a copy only where values really must be kept apart.
+ *
+ * Versions of a variable that end up in separate classes are separate
+ * variables to the register allocator, so reusing a local for
+ * unrelated values no longer ties them to the one register or slot.
+ */
+
+#ifndef _H_ssa
+#define _H_ssa
+
+#include <map>
+#include <set>
+#include <vector>
+#include "tac.h"
+class FlowGraph;
+class BasicBlock;
+class CodeGenerator;
+
+class SSAForm {
+  private:
+    FlowGraph *cfg;
+    CodeGenerator *cg;
+    std::vector<std::set<BasicBlock*> > frontier;    // per block
+    std::vector<std::vector<BasicBlock*> > children; // dominator tree
+    std::map<Location*, int> varIndex;  // variables being renamed
+    std::vector<Location*> vars;
+    std::vector<std::vector<Location*> > stacks;     // per variable
+    std::vector<int> numVersions;                    // per variable
+    std::map<Phi*, int> phiVar;
+    int numPhis, numCoalesced;
+
+    static bool IsTracked(Location *var);
+    void ComputeFrontiers();
+    void ChooseVariables();
+    void ComputeLiveIn(std::vector<std::vector<bool> > &liveIn);
+    void PlacePhis();
+    Location *NewVersion(int v);
+    Location *Current(Location *var);
+    void Rename(BasicBlock *b);
+    void Print();
+
+    void IsolatePhis();
+    void Coalesce(std::vector<Instruction*> &fn);
+
+  public:
+    SSAForm(FlowGraph *cfg, CodeGenerator *cg);
+
+         // Replaces the Phis by copies, coalesces what copies it can
+         // and writes the function's instructions to fn
+    void Destroy(std::vector<Instruction*> &fn);
+};
+
+#endif
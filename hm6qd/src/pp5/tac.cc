@@ -0,0 +1,501 @@
+/* File: tac.cc
+ * ------------
+ * Implementation of Location class and Instruction class/subclasses.
+ */
+  
+#include "tac.h"
+#include "mips.h"
+#include <cstring>
+#include <string>
+
+Location::Location(Segment s, int o, const char *name) :
+  variableName(strdup(name)), segment(s), offset(o), base(NULL) {}
+
+ 
+void Instruction::Print() {
+  printf("\t%s ;\n", printed);
+}
+
+void Instruction::Emit(Mips *mips) {
+  Mips::CurrentInstruction ci(*mips, this);
+  if (*printed)
+    mips->Emit("# %s", printed);   // emit TAC as comment into assembly
+  EmitSpecific(mips);
+} 
+
+LoadConstant::LoadConstant(Location *d, int v)
+  : dst(d), val(v) {
+  Assert(dst != NULL);
+  Describe();
+}
+void LoadConstant::Describe() {
+  sprintf(printed, "%s = %d", dst->GetName(), val);
+}
+void LoadConstant::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void LoadConstant::EmitSpecific(Mips *mips) {
+  mips->EmitLoadConstant(dst, val);
+}
+
+
+LoadStringConstant::LoadStringConstant(Location *d, const char *s, const char *l)
+  : dst(d), label(strdup(l)) {
+  Assert(dst != NULL && s != NULL && l != NULL);
+  const char *quote = (*s == '"') ? "" : "\"";
+  str = new char[strlen(s) + 2*strlen(quote) + 1];
+  sprintf(str, "%s%s%s", quote, s, quote);
+  Describe();
+}
+void LoadStringConstant::Describe() {
+  const char *quote = (strlen(str) > 50) ? "...\"" : "";
+  sprintf(printed, "%s = %.50s%s", dst->GetName(), str, quote);
+}
+void LoadStringConstant::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void LoadStringConstant::EmitSpecific(Mips *mips) {
+  mips->EmitLoadStringConstant(dst, label);
+}
+     
+
+LoadLabel::LoadLabel(Location *d, const char *l)
+  : dst(d), label(strdup(l)) {
+  Assert(dst != NULL && label != NULL);
+  Describe();
+}
+void LoadLabel::Describe() {
+  sprintf(printed, "%s = %s", dst->GetName(), label);
+}
+void LoadLabel::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void LoadLabel::EmitSpecific(Mips *mips) {
+  mips->EmitLoadLabel(dst, label);
+}
+
+
+Assign::Assign(Location *d, Location *s)
+  : dst(d), src(s) {
+  Assert(dst != NULL && src != NULL);
+  Describe();
+}
+void Assign::Describe() {
+  sprintf(printed, "%s = %s", dst->GetName(), src->GetName());
+}
+void Assign::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void Assign::SetSources(Location *srcs[]) {
+  src = srcs[0];
+  Describe();
+}
+void Assign::EmitSpecific(Mips *mips) {
+  mips->EmitCopy(dst, src);
+}
+int Assign::GetSources(Location *srcs[]) {
+  srcs[0] = src;
+  return 1;
+}
+
+
+Load::Load(Location *d, Location *s, int off, bool ro)
+  : dst(d), src(s), offset(off), readOnly(ro) {
+  Assert(dst != NULL && src != NULL);
+  Describe();
+}
+void Load::Describe() {
+  if (offset) 
+    sprintf(printed, "%s = *(%s + %d)", dst->GetName(), src->GetName(), offset);
+  else
+    sprintf(printed, "%s = *(%s)", dst->GetName(), src->GetName());
+}
+void Load::EmitSpecific(Mips *mips) {
+  mips->EmitLoad(dst, src, offset);
+}
+int Load::GetSources(Location *srcs[]) {
+  srcs[0] = src;
+  return 1;
+}
+void Load::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void Load::SetSources(Location *srcs[]) {
+  src = srcs[0];
+  Describe();
+}
+
+
+Store::Store(Location *d, Location *s, int off)
+  : dst(d), src(s), offset(off) {
+  Assert(dst != NULL && src != NULL);
+  Describe();
+}
+void Store::Describe() {
+  if (offset)
+    sprintf(printed, "*(%s + %d) = %s", dst->GetName(), offset, src->GetName());
+  else
+    sprintf(printed, "*(%s) = %s", dst->GetName(), src->GetName());
+}
+void Store::EmitSpecific(Mips *mips) {
+  mips->EmitStore(dst, src, offset);
+}
+int Store::GetSources(Location *srcs[]) {
+  srcs[0] = dst;   // the address is read, not written
+  srcs[1] = src;
+  return 2;
+}
+void Store::SetSources(Location *srcs[]) {
+  dst = srcs[0];
+  src = srcs[1];
+  Describe();
+}
+
+ 
+const char * const BinaryOp::opName[BinaryOp::NumOps]  = {"+", "-", "*", "/", "%", "==", "<", "&&", "||",
+							"!=", "<=", ">", ">=", ">=u", "-u"};
+
+BinaryOp::OpCode BinaryOp::OpCodeForName(const char *name) {
+  for (int i = 0; i < NumOps; i++) 
+    if (opName[i] && !strcmp(opName[i], name))
+	return (OpCode)i;
+  Failure("Unrecognized Tac operator: '%s'\n", name);
+  return Add; // can't get here, but compiler doesn't know that
+}
+
+BinaryOp::OpCode BinaryOp::Negate(OpCode relation) {
+  switch (relation) {
+    case Eq:        return NotEq;
+    case NotEq:     return Eq;
+    case Less:      return GreaterEq;
+    case GreaterEq: return Less;
+    case Greater:   return LessEq;
+    case LessEq:    return Greater;
+    default:        Failure("Tac operator '%s' is not a relation", opName[relation]);
+  }
+  return relation; // can't get here
+}
+
+BinaryOp::BinaryOp(OpCode c, Location *d, Location *o1, Location *o2)
+  : code(c), dst(d), op1(o1), op2(o2) {
+  Assert(dst != NULL && op1 != NULL && op2 != NULL);
+  Assert(code >= 0 && code < NumOps);
+  Describe();
+}
+void BinaryOp::Describe() {
+  sprintf(printed, "%s = %s %s %s", dst->GetName(), op1->GetName(), opName[code], op2->GetName());
+}
+void BinaryOp::EmitSpecific(Mips *mips) {	  
+  mips->EmitBinaryOp(code, dst, op1, op2);
+}
+int BinaryOp::GetSources(Location *srcs[]) {
+  srcs[0] = op1;
+  srcs[1] = op2;
+  return 2;
+}
+void BinaryOp::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void BinaryOp::SetSources(Location *srcs[]) {
+  op1 = srcs[0];
+  op2 = srcs[1];
+  Describe();
+}
+
+AddImm::AddImm(Location *d, Location *s, int i)
+  : dst(d), src(s), imm(i) {
+  Assert(dst != NULL && src != NULL);
+  Assert(imm >= MinImm && imm <= MaxImm);
+  Describe();
+}
+void AddImm::Describe() {
+  sprintf(printed, "%s = %s + %d", dst->GetName(), src->GetName(), imm);
+}
+void AddImm::EmitSpecific(Mips *mips) {
+  mips->EmitAddImm(dst, src, imm);
+}
+int AddImm::GetSources(Location *srcs[]) {
+  srcs[0] = src;
+  return 1;
+}
+void AddImm::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void AddImm::SetSources(Location *srcs[]) {
+  src = srcs[0];
+  Describe();
+}
+
+Label::Label(const char *l) : label(strdup(l)) {
+  Assert(label != NULL);
+  *printed = '\0';
+}
+void Label::Print() {
+  printf("%s:\n", label);
+}
+void Label::EmitSpecific(Mips *mips) {
+  mips->EmitLabel(label);
+}
+ 
+Goto::Goto(const char *l) : label(strdup(l)) {
+  Assert(label != NULL);
+  sprintf(printed, "Goto %s", label);
+}
+void Goto::EmitSpecific(Mips *mips) {	  
+  mips->EmitGoto(label);
+}
+
+CondBranch::CondBranch(const char *l) : label(strdup(l)) {
+  Assert(label != NULL);
+}
+
+IfZ::IfZ(Location *te, const char *l)
+   : CondBranch(l), test(te) {
+  Assert(test != NULL);
+  Describe();
+}
+void IfZ::Describe() {
+  sprintf(printed, "IfZ %s Goto %s", test->GetName(), label);
+}
+void IfZ::EmitSpecific(Mips *mips) {	  
+  mips->EmitIfZ(test, label);
+}
+int IfZ::GetSources(Location *srcs[]) {
+  srcs[0] = test;
+  return 1;
+}
+void IfZ::SetSources(Location *srcs[]) {
+  test = srcs[0];
+  Describe();
+}
+
+IfCmp::IfCmp(BinaryOp::OpCode r, Location *o1, Location *o2, const char *l)
+  : CondBranch(l), rel(r), op1(o1), op2(o2) {
+  Assert(op1 != NULL && op2 != NULL);
+  Describe();
+}
+void IfCmp::Describe() {
+  sprintf(printed, "If %s %s %s Goto %s", op1->GetName(),
+	  BinaryOp::opName[rel], op2->GetName(), label);
+}
+void IfCmp::EmitSpecific(Mips *mips) {
+  mips->EmitIfCmp(rel, op1, op2, label);
+}
+int IfCmp::GetSources(Location *srcs[]) {
+  srcs[0] = op1;
+  srcs[1] = op2;
+  return 2;
+}
+void IfCmp::SetSources(Location *srcs[]) {
+  op1 = srcs[0];
+  op2 = srcs[1];
+  Describe();
+}
+
+JumpTable::JumpTable(Location *i, const char *t, const std::vector<const char*> &l)
+  : index(i), table(strdup(t)), labels(l) {
+  Assert(index != NULL && !labels.empty());
+  Describe();
+}
+void JumpTable::Describe() {
+  std::string s = std::string("Goto ") + table + "[" + index->GetName() + "] (";
+  for (int i = 0; i < labels.size(); i++)
+    s += std::string(i ? ", " : "") + labels[i];
+  sprintf(printed, "%.120s)", s.c_str());
+}
+void JumpTable::EmitSpecific(Mips *mips) {
+  mips->EmitJumpTable(index, table, labels);
+}
+int JumpTable::GetSources(Location *srcs[]) {
+  srcs[0] = index;
+  return 1;
+}
+void JumpTable::SetSources(Location *srcs[]) {
+  index = srcs[0];
+  Describe();
+}
+
+BeginFunc::BeginFunc() {
+  sprintf(printed,"BeginFunc (unassigned)");
+  frameSize = -555; // used as sentinel to recognized unassigned value
+}
+void BeginFunc::SetFrameSize(int numBytesForAllLocalsAndTemps) {
+  frameSize = numBytesForAllLocalsAndTemps; 
+  sprintf(printed,"BeginFunc %d", frameSize);
+}
+void BeginFunc::EmitSpecific(Mips *mips) {
+  mips->EmitBeginFunction(frameSize);
+}
+
+EndFunc::EndFunc() : Instruction() {
+  sprintf(printed, "EndFunc");
+}
+void EndFunc::EmitSpecific(Mips *mips) {
+  mips->EmitEndFunction();
+}
+ 
+Return::Return(Location *v) : val(v) {
+  Describe();
+}
+void Return::Describe() {
+  sprintf(printed, "Return %s", val? val->GetName() : "");
+}
+void Return::EmitSpecific(Mips *mips) {	  
+  mips->EmitReturn(val);
+}
+int Return::GetSources(Location *srcs[]) {
+  if (!val) return 0;
+  srcs[0] = val;
+  return 1;
+}
+void Return::SetSources(Location *srcs[]) {
+  if (val) val = srcs[0];
+  Describe();
+}
+
+TailCall::TailCall(const char *l, const std::vector<Location*> &a)
+  : Return(NULL), label(strdup(l)), args(a) {
+  Assert(args.size() <= MaxSources);
+  Describe();
+}
+void TailCall::Describe() {
+  sprintf(printed, "TailCall %s", label);
+  for (int i = 0; i < args.size(); i++)
+    sprintf(printed + strlen(printed), "%s%s", i ? ", " : " (", args[i]->GetName());
+  if (!args.empty()) strcat(printed, ")");
+}
+void TailCall::EmitSpecific(Mips *mips) {
+  mips->EmitTailCall(label, args);
+}
+int TailCall::GetSources(Location *srcs[]) {
+  for (int i = 0; i < args.size(); i++)
+    srcs[i] = args[i];
+  return args.size();
+}
+void TailCall::SetSources(Location *srcs[]) {
+  for (int i = 0; i < args.size(); i++)
+    args[i] = srcs[i];
+  Describe();
+}
+
+PushParam::PushParam(Location *p)
+  :  param(p), slot(0), numSlots(1), viaRegs(false) {
+  Assert(param != NULL);
+  Describe();
+}
+void PushParam::Describe() {
+  sprintf(printed, "PushParam %s", param->GetName());
+}
+void PushParam::EmitSpecific(Mips *mips) {
+  mips->EmitParam(param, slot, numSlots, viaRegs);
+} 
+void PushParam::SetSlot(int s, int n, bool r) {
+  Assert(s >= 0 && s < n);
+  slot = s;
+  numSlots = n;
+  viaRegs = r;
+}
+int PushParam::GetSources(Location *srcs[]) {
+  srcs[0] = param;
+  return 1;
+}
+void PushParam::SetSources(Location *srcs[]) {
+  param = srcs[0];
+  Describe();
+}
+
+PopParams::PopParams(int nb)
+  :  numBytes(nb) {
+  sprintf(printed, "PopParams %d", numBytes);
+}
+void PopParams::EmitSpecific(Mips *mips) {
+  mips->EmitPopParams(numBytes);
+} 
+
+
+LCall::LCall(const char *l, Location *d)
+  :  label(strdup(l)), dst(d) {
+  Describe();
+}
+void LCall::Describe() {
+  sprintf(printed, "%s%sLCall %s", dst? dst->GetName(): "", dst?" = ":"", label);
+}
+void LCall::EmitSpecific(Mips *mips) {
+  mips->EmitLCall(dst, label);
+}
+void LCall::SetDst(Location *d) {
+  if (dst) dst = d;
+  Describe();
+}
+
+ACall::ACall(Location *ma, Location *d)
+  : dst(d), methodAddr(ma) {
+  Assert(methodAddr != NULL);
+  Describe();
+}
+void ACall::Describe() {
+  sprintf(printed, "%s%sACall %s", dst? dst->GetName(): "", dst?" = ":"",
+	    methodAddr->GetName());
+}
+void ACall::EmitSpecific(Mips *mips) {
+  mips->EmitACall(dst, methodAddr);
+} 
+int ACall::GetSources(Location *srcs[]) {
+  srcs[0] = methodAddr;
+  return 1;
+}
+void ACall::SetDst(Location *d) {
+  if (dst) dst = d;
+  Describe();
+}
+void ACall::SetSources(Location *srcs[]) {
+  methodAddr = srcs[0];
+  Describe();
+}
+
+VTable::VTable(const char *l, List<const char *> *m, const std::vector<int> &p)
+  : methodLabels(m), label(strdup(l)), pointerFields(p) {
+  Assert(methodLabels != NULL && label != NULL);
+  sprintf(printed, "VTable for class %s", l);
+}
+
+void VTable::Print() {
+  printf("VTable %s =\n", label);
+  for (int i = 0; i < methodLabels->NumElements(); i++) 
+    printf("\t%s,\n", methodLabels->Nth(i));
+  printf("; \n"); 
+}
+void VTable::EmitSpecific(Mips *mips) {
+  mips->EmitVTable(label, methodLabels, pointerFields);
+}
+
+
+Phi::Phi(Location *d, int numArgs)
+  : dst(d), args(numArgs, d) {
+  Assert(dst != NULL);
+  Describe();
+}
+void Phi::Describe() {
+  std::string s = std::string(dst->GetName()) + " = phi(";
+  for (int i = 0; i < args.size(); i++)
+    s += std::string(i ? ", " : "") + args[i]->GetName();
+  sprintf(printed, "%.120s)", s.c_str());
+}
+void Phi::EmitSpecific(Mips *mips) {
+  Failure("Tac '%s' must be removed before emitting code", printed);
+}
+void Phi::SetDst(Location *d) {
+  dst = d;
+  Describe();
+}
+void Phi::SetArg(int i, Location *l) {
+  args[i] = l;
+  Describe();
+}
@@ -0,0 +1,464 @@
+/* File: tac.h
+ * -----------
+ * This module contains the Instruction class (and its various
+ * subclasses) that represent Tac instructions and the Location
+ * class used for operands to those instructions.
+ *
+ * Each instruction is mostly just a little struct with a
+ * few fields, but each responds polymorphically to the methods
+ * Print and Emit, the first is used to print out the TAC form of
+ * the instruction (helpful when debugging) and the second to
+ * convert to the appropriate MIPS assembly.
+ *
+ * The operands to each instruction are of Location class.
+ * A Location object is a simple representation of where a variable
+ * exists at runtime, i.e. whether it is on the stack or global
+ * segment and at what offset relative to the current fp or gp.
+ *
+ * You may need to make changes/extensions to these classes
+ * if you are working on IR optimization.
+
+ */
+
+#ifndef _H_tac
+#define _H_tac
+
+#include <vector>
+#include "list.h" // for VTable
+class Mips;
+template<class Element> class List;
+
+    // A Location object is used to identify the operands to the
+    // various TAC instructions. A Location is either fp or gp
+    // relative (depending on whether in stack or global segemnt)
+    // and has an offset relative to the base of that segment.
+    // For example, a declaration for integer num as the first local
+    // variable in a function would be assigned a Location object
+    // with name "num", segment fpRelative, and offset -8. 
+ 
+typedef enum {fpRelative, gpRelative} Segment;
+
+class Location
+{
+  protected:
+    const char *variableName;
+    Segment segment;
+    int offset;
+    Location* base;
+	  
+  public:
+    Location(Segment seg, int offset, const char *name);
+
+    const char *GetName() const     { return variableName; }
+    Segment GetSegment() const      { return segment; }
+    int GetOffset() const           { return offset; }
+    Location* GetBase() const       { return base; }
+
+         // Used when frame slots are reassigned after code generation
+    void SetOffset(int off)         { offset = off; }
+};
+ 
+
+
+  // base class from which all Tac instructions derived
+  // has the interface for the 2 polymorphic messages: Print & Emit
+  
+class Instruction {
+    protected:
+      char printed[128];
+      virtual void Describe() {}  // fills printed from the operands
+	  
+    public:
+	virtual ~Instruction() {}
+	virtual void Print();
+	virtual void EmitSpecific(Mips *mips) = 0;
+	void Emit(Mips *mips);
+
+	// Operand access for the data-flow analyses (liveness, register
+	// allocation). GetDst returns the variable this instruction writes,
+	// or NULL if none. GetSources fills srcs with the variables it
+	// reads and returns how many there are: two at most, except for a
+	// TailCall, which reads each of the args it passes in $a0-$a3.
+	// IsCall is true for the instructions that transfer control to
+	// another function.
+	static const int MaxSources = 4;
+	virtual Location *GetDst() { return NULL; }
+	virtual int GetSources(Location *srcs[MaxSources]) { return 0; }
+	virtual bool IsCall() { return false; }
+
+	// Operand update for the passes that rename variables (SSA).
+	// SetDst replaces the variable written (ignored if there is none)
+	// and SetSources the ones read, in the order GetSources gives them.
+	virtual void SetDst(Location *dst) {}
+	virtual void SetSources(Location *srcs[MaxSources]) {}
+
+	// A copy of the instruction, operands and all (for the inliner)
+	virtual Instruction *Clone() = 0;
+};
+
+  
+  
+  // for convenience, the instruction classes are listed here.
+  // the interfaces for the classes follows below
+  
+  class LoadConstant;
+  class LoadStringConstant;
+  class LoadLabel;
+  class Assign;
+  class Load;
+  class Store;
+  class BinaryOp;
+  class AddImm;
+  class Label;
+  class Goto;
+  class CondBranch;
+  class IfZ;
+  class IfCmp;
+  class JumpTable;
+  class BeginFunc;
+  class EndFunc;
+  class Return;
+  class TailCall;
+  class PushParam;
+  class PopParams;
+  class LCall;
+  class ACall;
+  class VTable;
+  class Phi;
+
+
+
+class LoadConstant: public Instruction {
+    Location *dst;
+    int val;
+    void Describe();
+  public:
+    LoadConstant(Location *dst, int val);
+    Location *GetDst() { return dst; }
+    int value() const { return val; }
+    void SetDst(Location *d);
+    Instruction *Clone() { return new LoadConstant(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class LoadStringConstant: public Instruction {
+    Location *dst;
+    char *str;
+    const char *label;                  // of the pooled copy of the string
+    void Describe();
+  public:
+    LoadStringConstant(Location *dst, const char *s, const char *label);
+    Location *GetDst() { return dst; }
+    const char *pool_label() const { return label; }
+    void SetDst(Location *d);
+    Instruction *Clone() { return new LoadStringConstant(*this); }
+    void EmitSpecific(Mips *mips);
+};
+    
+class LoadLabel: public Instruction {
+    Location *dst;
+    const char *label;
+    void Describe();
+  public:
+    LoadLabel(Location *dst, const char *label);
+    Location *GetDst() { return dst; }
+    const char *text() const { return label; }
+    void SetDst(Location *d);
+    Instruction *Clone() { return new LoadLabel(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class Assign: public Instruction {
+    Location *dst, *src;
+    void Describe();
+  public:
+    Assign(Location *dst, Location *src);
+    Location *GetDst() { return dst; }
+    int GetSources(Location *srcs[MaxSources]);
+    void SetDst(Location *d);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new Assign(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class Load: public Instruction {
+    Location *dst, *src;
+    int offset;
+    bool readOnly;      // word never changes once set (vtable, array length)
+    void Describe();
+  public:
+    Load(Location *dst, Location *src, int offset = 0, bool readOnly = false);
+    Location *GetDst() { return dst; }
+    int GetOffset() const { return offset; }
+    bool IsReadOnly() const { return readOnly; }
+    int GetSources(Location *srcs[MaxSources]);
+    void SetDst(Location *d);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new Load(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class Store: public Instruction {
+    Location *dst, *src;
+    int offset;
+    void Describe();
+  public:
+    Store(Location *d, Location *s, int offset = 0);
+    int GetOffset() const { return offset; }
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new Store(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class BinaryOp: public Instruction {
+
+  public:
+    typedef enum {Add, Sub, Mul, Div, Mod, Eq, Less, And, Or,
+		  NotEq, LessEq, Greater, GreaterEq, UnsignedGreaterEq,
+		  UnsignedSub,        // wraps rather than trapping on overflow
+		  NumOps} OpCode;
+    static const char * const opName[NumOps];
+    static OpCode OpCodeForName(const char *name);
+    static OpCode Negate(OpCode relation); // e.g. Less -> GreaterEq
+    
+  protected:
+    OpCode code;
+    Location *dst, *op1, *op2;
+    void Describe();
+  public:
+    BinaryOp(OpCode c, Location *dst, Location *op1, Location *op2);
+    Location *GetDst() { return dst; }
+    OpCode opcode() const { return code; }
+    int GetSources(Location *srcs[MaxSources]);
+    void SetDst(Location *d);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new BinaryOp(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+  // dst = src + a constant small enough for an add-immediate. Not made
+  // by the code generator directly, only by instruction selection once
+  // the function has been optimized (see CodeGenerator::SelectImmediates)
+class AddImm: public Instruction {
+    Location *dst, *src;
+    int imm;
+    void Describe();
+  public:
+    static const int MinImm = -32768, MaxImm = 32767;
+    AddImm(Location *dst, Location *src, int imm);
+    Location *GetDst() { return dst; }
+    int value() const { return imm; }
+    int GetSources(Location *srcs[MaxSources]);
+    void SetDst(Location *d);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new AddImm(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class Label: public Instruction {
+    const char *label;
+  public:
+    Label(const char *label);
+    void Print();
+    Instruction *Clone() { return new Label(*this); }
+    void EmitSpecific(Mips *mips);
+    const char* text() const { return label; }
+};
+
+class Goto: public Instruction {
+    const char *label;
+  public:
+    Goto(const char *label);
+    Instruction *Clone() { return new Goto(*this); }
+    void EmitSpecific(Mips *mips);
+    const char* branch_label() const { return label; }
+};
+
+  // common base of the two-way branches, which either jump to their
+  // label or fall through to the next instruction
+class CondBranch: public Instruction {
+  protected:
+    const char *label;
+    CondBranch(const char *l);
+  public:
+    const char* branch_label() const { return label; }
+};
+
+class IfZ: public CondBranch {
+    Location *test;
+    void Describe();
+  public:
+    IfZ(Location *test, const char *label);
+    Instruction *Clone() { return new IfZ(*this); }
+    void EmitSpecific(Mips *mips);
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+};
+
+  // fused compare and branch: jumps if "op1 rel op2" holds, where rel
+  // is one of the relational/equality BinaryOp codes
+class IfCmp: public CondBranch {
+    BinaryOp::OpCode rel;
+    Location *op1, *op2;
+    void Describe();
+  public:
+    IfCmp(BinaryOp::OpCode rel, Location *op1, Location *op2, const char *label);
+    Instruction *Clone() { return new IfCmp(*this); }
+    void EmitSpecific(Mips *mips);
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+    BinaryOp::OpCode opcode() const { return rel; }
+};
+
+  // a multi-way branch: jumps to the label the index (which must be in
+  // range) selects from a table of labels laid out in the data segment
+class JumpTable: public Instruction {
+    Location *index;
+    const char *table;
+    std::vector<const char*> labels;
+    void Describe();
+  public:
+    JumpTable(Location *index, const char *table, const std::vector<const char*> &labels);
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+    const char *table_label() const { return table; }
+    const std::vector<const char*> &branch_labels() const { return labels; }
+    Instruction *Clone() { return new JumpTable(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class BeginFunc: public Instruction {
+    int frameSize;
+  public:
+    BeginFunc();
+    // used to backpatch the instruction with frame size once known
+    void SetFrameSize(int numBytesForAllLocalsAndTemps);
+    Instruction *Clone() { return new BeginFunc(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class EndFunc: public Instruction {
+  public:
+    EndFunc();
+    Instruction *Clone() { return new EndFunc(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class Return: public Instruction {
+    Location *val;
+    void Describe();
+  public:
+    Return(Location *val);
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new Return(*this); }
+    void EmitSpecific(Mips *mips);
+};   
+
+  // a call in tail position, whose result is the caller's own: the
+  // args (no more than fit in $a0-$a3) are passed in registers, the caller's
+  // frame is popped and the callee is jumped to, so that it returns
+  // straight to the caller's caller. As it leaves the function it is
+  // a kind of Return to the flow analyses.
+class TailCall: public Return {
+    const char *label;
+    std::vector<Location*> args;        // by slot, the first arg first
+    void Describe();
+  public:
+    TailCall(const char *label, const std::vector<Location*> &args);
+    const char *function_label() const { return label; }
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+    bool IsCall() { return true; }
+    Instruction *Clone() { return new TailCall(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class PushParam: public Instruction {
+    Location *param;
+    int slot, numSlots;         // which arg of the call (0 = pushed last)
+    bool viaRegs;               // the call passes args in $a0-$a3
+    void Describe();
+  public:
+    PushParam(Location *param);
+    int GetSources(Location *srcs[MaxSources]);
+    void SetSources(Location *srcs[MaxSources]);
+    void SetSlot(int slot, int numSlots, bool viaRegs);
+    Instruction *Clone() { return new PushParam(*this); }
+    void EmitSpecific(Mips *mips);
+}; 
+
+class PopParams: public Instruction {
+    int numBytes;
+  public:
+    PopParams(int numBytesOfParamsToRemove);
+    int GetNumBytes() const { return numBytes; }
+    Instruction *Clone() { return new PopParams(*this); }
+    void EmitSpecific(Mips *mips);
+}; 
+
+class LCall: public Instruction {
+    const char *label;
+    Location *dst;
+    void Describe();
+  public:
+    LCall(const char *labe, Location *result);
+    Location *GetDst() { return dst; }
+    const char *function_label() const { return label; }
+    bool IsCall() { return true; }
+    void SetDst(Location *d);
+    Instruction *Clone() { return new LCall(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class ACall: public Instruction {
+    Location *dst, *methodAddr;
+    void Describe();
+  public:
+    ACall(Location *meth, Location *result);
+    Location *GetDst() { return dst; }
+    int GetSources(Location *srcs[MaxSources]);
+    bool IsCall() { return true; }
+    void SetDst(Location *d);
+    void SetSources(Location *srcs[MaxSources]);
+    Instruction *Clone() { return new ACall(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+  // SSA merge of one value per predecessor of its block, taken in the
+  // order of the FlowGraph's preds. Phis exist only between building
+  // SSA form and leaving it, and can't be emitted. Their arguments are
+  // read on the incoming edges, not where the Phi stands, so they are
+  // reached through GetArg rather than GetSources.
+class Phi: public Instruction {
+    Location *dst;
+    std::vector<Location*> args;
+    void Describe();
+  public:
+    Phi(Location *dst, int numArgs);
+    Location *GetDst() { return dst; }
+    void SetDst(Location *d);
+    int NumArgs() const { return args.size(); }
+    Location *GetArg(int i) const { return args[i]; }
+    void SetArg(int i, Location *arg);
+    Instruction *Clone() { return new Phi(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+class VTable: public Instruction {
+    List<const char *> *methodLabels;
+    const char *label;
+    std::vector<int> pointerFields;
+ public:
+    VTable(const char *labelForTable, List<const char *> *methodLabels,
+           const std::vector<int> &pointerFields);
+    const char *table_label() const { return label; }
+    List<const char *> *method_labels() const { return methodLabels; }
+    void Print();
+    Instruction *Clone() { return new VTable(*this); }
+    void EmitSpecific(Mips *mips);
+};
+
+
+#endif
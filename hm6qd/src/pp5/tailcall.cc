@@ -0,0 +1,155 @@
+/* File: tailcall.cc
+ * -----------------
+ * Implementation of the TailCallElimination class.
+ */
+
+#include "tailcall.h"
+#include "codegen.h"
+#include "mips.h"
+#include <cstring>
+
+
+TailCallElimination::TailCallElimination(CodeGenerator *c, const char *l)
+  : cg(c), fnLabel(l), entryLabel(NULL), numSelf(0), numOther(0)
+{
+}
+
+/* Method: FindParams
+ * ------------------
+ * Collects the Locations the function refers to its params by, by slot
+ * (there may be more than one per slot, as for this).
+ */
+void TailCallElimination::FindParams(std::vector<Instruction*> &fn)
+{
+  Location *srcs[Instruction::MaxSources + 1];
+  for (int i = 0; i < fn.size(); i++) {
+    int n = fn[i]->GetSources(srcs);
+    if (fn[i]->GetDst()) srcs[n++] = fn[i]->GetDst();
+    for (int j = 0; j < n; j++) {
+      int slot = (srcs[j]->GetOffset() - CodeGenerator::OffsetToFirstParam) / CodeGenerator::VarSize;
+      if (srcs[j]->GetSegment() == fpRelative && srcs[j]->GetOffset() >= CodeGenerator::OffsetToFirstParam)
+        params[slot].insert(srcs[j]);
+    }
+  }
+}
+
+int TailCallElimination::FindLabel(std::vector<Instruction*> &fn, const char *label)
+{
+  for (int i = 0; i < fn.size(); i++) {
+    Label *l = dynamic_cast<Label*>(fn[i]);
+    if (l && !strcmp(l->text(), label))
+      return i;
+  }
+  return -1;
+}
+
+/* Method: IsTail
+ * --------------
+ * Does the function return result (or nothing, if result is NULL)
+ * right after pos, once it has gone through any labels, jumps and
+ * copies of result in the way?
+ */
+bool TailCallElimination::IsTail(std::vector<Instruction*> &fn, int pos, Location *result)
+{
+  Location *srcs[Instruction::MaxSources];
+  for (int steps = 0; pos >= 0 && pos < fn.size() && steps < fn.size(); steps++) {
+    Instruction *instr = fn[pos];
+    Goto *g = dynamic_cast<Goto*>(instr);
+    if (dynamic_cast<EndFunc*>(instr))
+      return true;
+    if (dynamic_cast<Return*>(instr)) {
+      int n = instr->GetSources(srcs);
+      return n == 0 || srcs[0] == result;
+    }
+    if (dynamic_cast<Label*>(instr)) {
+      pos++;
+    } else if (g) {
+      pos = FindLabel(fn, g->branch_label());
+    } else if (dynamic_cast<Assign*>(instr) && result && instr->GetSources(srcs) &&
+               srcs[0] == result) {
+      result = instr->GetDst();
+      pos++;
+    } else
+      return false;
+  }
+  return false;
+}
+
+/* Method: ReplaceSelfCall
+ * -----------------------
+ * Appends the code that passes args (by slot) to the function itself
+ * again: each new value goes through a temp, so none is overwritten
+ * before it is read, then into every Location of its param, and the
+ * function starts over from its entry label.
+ */
+void TailCallElimination::ReplaceSelfCall(std::vector<Instruction*> &out,
+                                          const std::vector<Location*> &args)
+{
+  if (!entryLabel) entryLabel = cg->NewLabel();
+  int numArgs = args.size();
+  std::vector<Location*> temps(numArgs);
+  for (int k = 0; k < numArgs; k++) {
+    if (!params.count(k)) continue;
+    temps[k] = cg->GenTempVar();
+    out.push_back(new Assign(temps[k], args[k]));
+  }
+  for (int k = 0; k < numArgs; k++) {
+    if (!params.count(k)) continue;
+    std::set<Location*>::iterator it;
+    for (it = params[k].begin(); it != params[k].end(); ++it)
+      out.push_back(new Assign(*it, temps[k]));
+  }
+  out.push_back(new Goto(entryLabel));
+  numSelf++;
+}
+
+void TailCallElimination::Rewrite(std::vector<Instruction*> &fn)
+{
+  FindParams(fn);
+  std::vector<Instruction*> out;
+  for (int i = 0; i < fn.size(); i++) {
+    LCall *call = dynamic_cast<LCall*>(fn[i]);
+    PopParams *pop = call && i + 1 < fn.size() ? dynamic_cast<PopParams*>(fn[i+1]) : NULL;
+    int numArgs = pop ? pop->GetNumBytes() / CodeGenerator::VarSize : 0;
+    int next = pop ? i + 2 : i + 1;
+    if (!call || numArgs > out.size() || !IsTail(fn, next, call->GetDst())) {
+      out.push_back(fn[i]);
+      continue;
+    }
+    const char *label = call->function_label();
+    bool self = !strcmp(label, fnLabel);
+    if (!self && (CodeGenerator::IsBuiltIn(label) ||
+                  numArgs > Mips::NumArgRegs)) {
+      out.push_back(fn[i]);
+      continue;
+    }
+    std::vector<Location*> args(numArgs);   // by slot, the last pushed first
+    Location *srcs[Instruction::MaxSources];
+    bool pushed = true;
+    for (int k = 0; k < numArgs; k++) {
+      Instruction *push = out[out.size() - 1 - k];
+      pushed = pushed && dynamic_cast<PushParam*>(push);
+      if (pushed) {
+        push->GetSources(srcs);
+        args[k] = srcs[0];
+      }
+    }
+    if (!pushed) {
+      out.push_back(fn[i]);
+      continue;
+    }
+    out.resize(out.size() - numArgs);
+    if (self)
+      ReplaceSelfCall(out, args);
+    else {
+      out.push_back(new TailCall(label, args));
+      numOther++;
+    }
+    i = next - 1;
+  }
+  if (entryLabel)
+    out.insert(out.begin() + 1, new Label(entryLabel));
+  fn = out;
+  PrintDebug("tailcall", "%s: %d self calls made jumps, %d other tail calls",
+             fnLabel, numSelf, numOther);
+}
@@ -0,0 +1,52 @@
+/* File: tailcall.h
+ * ----------------
+ * The TailCallElimination class rewrites the direct calls (LCall) of
+ * one function whose result is at once returned, so they no longer
+ * grow the stack.
+ *
+ * A call of the function to itself becomes a loop: the pushed values
+ * are copied into temps, then into the params (through the temps, as
+ * the new values may be computed from the old), and control jumps to a
+ * label placed just after BeginFunc.
+ *
+ * A call to another function becomes a TailCall, which passes its args
+ * in registers, pops the caller's frame and jumps to the callee, which
+ * then returns straight to the caller's caller. Only a call whose args
+ * all fit in $a0-$a3 qualifies, so nothing need be left on the stack
+ * for the callee. Built-ins are called as usual.
+ *
+ * A call is in tail position if what follows it, through labels,
+ * jumps and copies of its result, is a Return of that result, a
+ * Return of nothing or the end of the function.
+ */
+
+#ifndef _H_tailcall
+#define _H_tailcall
+
+#include <map>
+#include <set>
+#include <vector>
+#include "tac.h"
+class CodeGenerator;
+
+class TailCallElimination {
+  private:
+    CodeGenerator *cg;
+    const char *fnLabel;
+    const char *entryLabel;             // NULL until a self call is found
+    std::map<int, std::set<Location*> > params;   // by slot
+    int numSelf, numOther;
+
+    void FindParams(std::vector<Instruction*> &fn);
+    static int FindLabel(std::vector<Instruction*> &fn, const char *label);
+    static bool IsTail(std::vector<Instruction*> &fn, int pos, Location *result);
+    void ReplaceSelfCall(std::vector<Instruction*> &out, const std::vector<Location*> &args);
+
+  public:
+    TailCallElimination(CodeGenerator *cg, const char *fnLabel);
+
+         // Rewrites the tail calls of fn
+    void Rewrite(std::vector<Instruction*> &fn);
+};
+
+#endif
@@ -0,0 +1,113 @@
+/* File: utiliy.cc
+ * ---------------
+ * Implementation of simple printing functions to report failures or
+ * debugging information triggered by keys.
+ */
+
+#include "utility.h"
+#include <stdarg.h>
+#include "list.h"
+#include <string.h>
+
+static List<const char*> debugKeys;
+static int optLevel = 2;
+static FILE *programInput = NULL;
+static const int BufferSize = 2048;
+
+void Failure(const char *format, ...)
+{
+  va_list args;
+  char errbuf[BufferSize];
+  
+  va_start(args, format);
+  vsprintf(errbuf, format, args);
+  va_end(args);
+  fflush(stdout);
+  fprintf(stderr,"\n*** Failure: %s\n\n", errbuf);
+  abort();
+}
+
+
+
+int IndexOf(const char *key)
+{
+   for (int i = 0; i < debugKeys.NumElements(); i++)
+      if (!strcmp(debugKeys.Nth(i), key)) return i;
+   return -1;
+}
+
+bool IsDebugOn(const char *key)
+{
+   return (IndexOf(key) != -1);
+}
+
+
+void SetDebugForKey(const char *key, bool value)
+{
+  int k = IndexOf(key);
+  if (!value && k != -1)
+    debugKeys.RemoveAt(k);
+  else if (value && k == -1)
+    debugKeys.Append(key);
+}
+
+
+
+int OptimizationLevel()
+{
+  return optLevel;
+}
+
+void SetOptimizationLevel(int level)
+{
+  optLevel = level;
+}
+
+FILE *ProgramInput()
+{
+  return programInput ? programInput : stdin;
+}
+
+
+
+void PrintDebug(const char *key, const char *format, ...)
+{
+  va_list args;
+  char buf[BufferSize];
+
+  if (!IsDebugOn(key))
+     return;
+  
+  va_start(args, format);
+  vsprintf(buf, format, args);
+  va_end(args);
+  printf("+++ (%s): %s%s", key, buf, buf[strlen(buf)-1] != '\n'? "\n" : "");
+}
+
+
+void ParseCommandLine(int argc, char *argv[])
+{
+  int first = 1;
+  if (argc > 1 && !strncmp(argv[1], "-O", 2)) {
+    SetOptimizationLevel(atoi(argv[1] + 2));
+    first++;
+  }
+  if (argc > first + 1 && !strcmp(argv[first], "-i")) {
+    if (!(programInput = fopen(argv[first + 1], "r"))) {
+      printf("Cannot read %s\n", argv[first + 1]);
+      exit(2);
+    }
+    first += 2;
+  }
+  if (argc == first)
+    return;
+  
+  if (strcmp(argv[first], "-d") != 0) { // next arg is not -d
+    printf("Usage:   [-O<level>] [-i <input-file>] -d <debug-key-1> <debug-key-2> ... \n");
+    exit(2);
+  }
+
+  for (int i = first + 1; i < argc; i++)
+    SetDebugForKey(argv[i], true);
+}
+